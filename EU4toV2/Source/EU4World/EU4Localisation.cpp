@@ -22,59 +22,127 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 #include "EU4Localisation.h"
-#include <fstream>
+#include <cstring>
 #include <vector>
 #include <set>
 #include "OSCompatibilityLayer.h"
+#include "ParallelFor.h"
 using namespace std;
 
 
 
+void EU4Localisation::AddRequiredKey(const std::string& key)
+{
+	requiredKeys.insert(key);
+}
+
 void EU4Localisation::ReadFromFile(const std::string& fileName)
 {
-	std::ifstream in(fileName);
+	AddFileLocalisations(ScanFile(fileName));
+}
 
-	const int maxLineLength = 10000;	// the maximum line length
-	char line[maxLineLength];			// the line being processed
+void EU4Localisation::ReadFromAllFilesInFolder(const std::string& folderPath)
+{
+	// Get all files in the folder.
+	set<string> fileNames;
+	Utils::GetAllFilesInFolder(folderPath, fileNames);
+	vector<string> filePaths;	// the files in the order they're added
+	for (const auto& fileName : fileNames)
+	{
+		filePaths.push_back(folderPath + '/' + fileName);
+	}
+
+	// Read all these files, then add them in order so later files still override earlier ones.
+	vector<FileLocalisations> fileLocalisations(filePaths.size());	// the localisations from each file
+	Utils::parallelFor(filePaths.size(), [&](size_t i)
+	{
+		fileLocalisations[i] = ScanFile(filePaths[i]);
+	});
+	for (const auto& localisationsInFile : fileLocalisations)
+	{
+		AddFileLocalisations(localisationsInFile);
+	}
+}
+
+EU4Localisation::FileLocalisations EU4Localisation::ScanFile(const std::string& fileName) const
+{
+	FileLocalisations fileLocalisations;	// the localisations found in the file
+
+	Utils::mappedFile file(fileName);	// the contents of the file
+	if (!file.isOpen() || (file.getSize() == 0))
+	{
+		return fileLocalisations;
+	}
+	const char* position = file.begin();	// the start of the current line
+	const char* end = file.end();				// the end of the file
 
 	// First line is the language like "l_english:"
-	in.getline(line, maxLineLength);
-	std::string language = DetermineLanguageForFile(RemoveUTF8BOM(line));
-	if (language.empty())
+	const char* lineEnd = static_cast<const char*>(memchr(position, '\n', end - position));	// the end of the current line
+	if (lineEnd == nullptr)
+	{
+		lineEnd = end;
+	}
+	fileLocalisations.language = DetermineLanguageForFile(RemoveUTF8BOM(std::string(position, lineEnd)));
+	if (fileLocalisations.language.empty())
 	{
-		return;
+		return fileLocalisations;
 	}
 
-	// Subsequent lines are 'KEY: "Text"'
-	while (!in.eof())
+	// Subsequent lines are 'KEY: "Text"'. As when reading line by line, a final line without a newline isn't used.
+	while (lineEnd != end)
 	{
-		in.getline(line, maxLineLength);
-		if (!in.eof())
+		position = lineEnd + 1;
+		lineEnd = static_cast<const char*>(memchr(position, '\n', end - position));
+		if (lineEnd == nullptr)
+		{
+			break;
+		}
+		const char* textEnd = ((lineEnd != position) && (*(lineEnd - 1) == '\r')) ? lineEnd - 1 : lineEnd;	// the line without its carriage return
+
+		// Only lines with a required key are turned into strings
+		const char* keyBegin = position;	// the start of the key
+		if (((textEnd - keyBegin) >= 3) && (memcmp(keyBegin, "\xEF\xBB\xBF", 3) == 0))
+		{
+			keyBegin += 3;
+		}
+		const char* textBegin = keyBegin;	// the line without any BOM
+		while ((keyBegin != textEnd) && (*keyBegin == ' '))
 		{
-			const auto keyLocalisationPair = DetermineKeyLocalisationPair(RemoveUTF8BOM(line));		// the localisation pair
-			const std::string& key = keyLocalisationPair.first;												// the key from the pair
-			const std::string& currentLocalisation = keyLocalisationPair.second;							// the localisation from the pair
-			if (!key.empty() && !currentLocalisation.empty())
-			{
-				localisations[key][language] = currentLocalisation;
-			}
+			keyBegin++;
+		}
+		if ((textEnd - keyBegin) < 2)
+		{
+			continue;
+		}
+		const char* keyEnd = static_cast<const char*>(memchr(keyBegin + 1, ':', textEnd - keyBegin - 1));	// the end of the key
+		if ((keyEnd == nullptr) || !IsRequiredKey(keyBegin, keyEnd))
+		{
+			continue;
+		}
+
+		auto keyLocalisationPair = DetermineKeyLocalisationPair(std::string(textBegin, textEnd));		// the localisation pair
+		if (!keyLocalisationPair.first.empty() && !keyLocalisationPair.second.empty())
+		{
+			fileLocalisations.localisations.push_back(std::move(keyLocalisationPair));
 		}
 	}
+
+	return fileLocalisations;
 }
 
-void EU4Localisation::ReadFromAllFilesInFolder(const std::string& folderPath)
+void EU4Localisation::AddFileLocalisations(const FileLocalisations& fileLocalisations)
 {
-	// Get all files in the folder.
-	set<string> fileNames;
-	Utils::GetAllFilesInFolder(folderPath, fileNames);
-
-	// Read all these files.
-	for (const auto& fileName : fileNames)
+	for (const auto& keyLocalisationPair : fileLocalisations.localisations)
 	{
-		ReadFromFile(folderPath + '/' + fileName);
+		localisations[keyLocalisationPair.first][fileLocalisations.language] = keyLocalisationPair.second;
 	}
 }
 
+bool EU4Localisation::IsRequiredKey(const char* keyBegin, const char* keyEnd) const
+{
+	return requiredKeys.empty() || (requiredKeys.count(std::string(keyBegin, keyEnd)) > 0);
+}
+
 const std::string& EU4Localisation::GetText(const std::string& key, const std::string& language) const
 {
 	static const std::string noLocalisation = "";	// used if there's no localisation
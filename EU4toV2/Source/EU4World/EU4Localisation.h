@@ -27,17 +27,24 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 // Holds a map from key to localised text for all languages in which 
 // the localisation is provided.
 class EU4Localisation
 {
 public:
+	// Only localisations for keys added here are kept when files are read, which saves holding
+	// every text in the game. If no keys are added, all localisations are kept.
+	void AddRequiredKey(const std::string& key);
+
 	// Adds all localisations found in the specified file. The file should begin with
 	// a line like "l_english:" to indicate what language the texts are in.
 	void ReadFromFile(const std::string& fileName);
-	// Adds all localisations found in files in the specified folder as per ReadFromFile().
+	// Adds all localisations found in files in the specified folder as per ReadFromFile(). The
+	// files are read in parallel, and later files still override earlier ones.
 	void ReadFromAllFilesInFolder(const std::string& folderPath);
 
 	// Returns the localised text for the given key in the specified language. Returns
@@ -48,6 +55,20 @@ public:
 	const std::map<std::string, std::string>& GetTextInEachLanguage(const std::string& key) const;
 
 private:
+	typedef std::vector<std::pair<std::string, std::string>> KeyLocalisationPairs;
+	struct FileLocalisations
+	{
+		std::string language;					// the language the file is in
+		KeyLocalisationPairs localisations;	// the required localisations in the file, in file order
+	};
+
+	// Returns the required localisations in the specified file without adding them.
+	FileLocalisations ScanFile(const std::string& fileName) const;
+	// Adds localisations returned by ScanFile(), replacing any earlier ones for the same keys.
+	void AddFileLocalisations(const FileLocalisations& fileLocalisations);
+	// Returns whether the key from a line should be kept.
+	bool IsRequiredKey(const char* keyBegin, const char* keyEnd) const;
+
 	// Returns the language name from text in the form "l_english:". Returns an empty string
 	// if the text doesn't fit this format.
 	static std::string DetermineLanguageForFile(const std::string& text);
@@ -62,6 +83,7 @@ private:
 	typedef std::map<std::string, std::string> LanguageToLocalisationMap;
 	typedef std::unordered_map<std::string, LanguageToLocalisationMap> KeyToLocalisationsMap;
 	KeyToLocalisationsMap localisations;	// a map between keys and localisations
+	std::unordered_set<std::string> requiredKeys;	// the keys to keep localisations for, or empty to keep all of them
 };
 
 #endif
\ No newline at end of file
@@ -44,17 +44,9 @@ EU4Province::EU4Province(Object* obj)
 
 	num = 0 - atoi(obj->getKey().c_str());
 
-	vector<Object*> baseTaxObjs;			// the object holding the base tax
-	baseTaxObjs = obj->getValue("base_tax");
-	baseTax = (baseTaxObjs.size() > 0) ? atof(baseTaxObjs[0]->getLeaf().c_str()) : 0.0f;
-
-	vector<Object*> baseProdObjs;			// the object holding the base production
-	baseProdObjs = obj->getValue("base_production");
-	baseProd = (baseProdObjs.size() > 0) ? atof(baseProdObjs[0]->getLeaf().c_str()) : 0.0f;
-
-	vector<Object*> baseManpowerObjs;		// the object holding the base manpower
-	baseManpowerObjs = obj->getValue("base_manpower");
-	manpower = (baseManpowerObjs.size() > 0) ? atof(baseManpowerObjs[0]->getLeaf().c_str()) : 0.0f;
+	baseTax = atof(obj->safeGetString("base_tax", "0").c_str());
+	baseProd = atof(obj->safeGetString("base_production", "0").c_str());
+	manpower = atof(obj->safeGetString("base_manpower", "0").c_str());
 
 	// for old versions of EU4 (< 1.12), copy tax to production if necessary
 	if (baseProd == 0.0f && baseTax > 0.0f)
@@ -62,21 +54,16 @@ EU4Province::EU4Province(Object* obj)
 		baseProd = baseTax;
 	}
 
-	vector<Object*> ownerObjs;				// the object holding the owner
-	ownerObjs = obj->getValue("owner");
-	(ownerObjs.size() == 0) ? ownerString = "" : ownerString = ownerObjs[0]->getLeaf();
+	ownerString = obj->safeGetString("owner");
 	owner = NULL;
 
 	cores.clear();
-	vector<Object*> coreObjs;				// the object holding the cores
-	coreObjs = obj->getValue("core");
-	for (unsigned int i = 0; i < coreObjs.size(); i++)
+	for (auto coreObj: obj->getRange("core"))
 	{
-		cores.push_back(coreObjs[i]->getLeaf());
+		cores.push_back(coreObj->getLeaf());
 	}
 
-	vector<Object*> hreObj = obj->getValue("hre");
-	if ((hreObj.size() > 0) && (hreObj[0]->getLeaf() == "yes"))
+	if (obj->safeGetString("hre") == "yes")
 	{
 		inHRE = true;
 	}
@@ -279,8 +266,6 @@ EU4Province::EU4Province(Object* obj)
 	checkBuilding(obj, "canal");
 	checkBuilding(obj, "road_network");
 	checkBuilding(obj, "post_office");
-
-	buildPopRatios();
 }
 
 
@@ -325,17 +310,18 @@ bool EU4Province::wasColonised() const
 }
 
 
-bool EU4Province::wasInfidelConquest() const
+bool EU4Province::wasInfidelConquest(vector<string>& warnings) const
 {
 	// returns true if the province was originally pagan, the current owner is non-pagan,
 	// and the province was NOT colonized
+	// any warning is added to warnings rather than logged, as provinces are converted in parallel
 	if (religionHistory.size() > 0 && !wasColonised())
 	{
 		EU4Religion* firstReligion = EU4Religion::getReligion(religionHistory[0].second);	// the first religion of this province
 		EU4Religion* ownerReligion = EU4Religion::getReligion(owner->getReligion());			// the owner's religion
 		if ((firstReligion == NULL) || (ownerReligion == NULL))
 		{
-			LOG(LogLevel::Warning) << "Unhandled religion in EU4 province " << num;
+			warnings.push_back("Unhandled religion in EU4 province " + to_string(num));
 			return true;
 		}
 		else
@@ -413,19 +399,21 @@ void EU4Province::checkBuilding(const Object* provinceObj, string building)
 
 void EU4Province::buildPopRatios()
 {
+	static const date earliestEndDate("1821.1.1");
+	static const date noMoreChangesDate("2000.1.1");
+
 	date endDate = Configuration::getLastEU4Date();
-	if (endDate < date("1821.1.1"))
+	if (endDate < earliestEndDate)
 	{
-		endDate = date("1821.1.1");
+		endDate = earliestEndDate;
 	}
-	date cutoffDate	 = endDate;
-	cutoffDate.year	-= 200;
+	const int cutoffYear = endDate.year - 200;
 
 	// fast-forward to 200 years before the end date (200 year decay means any changes before then will be at 100%)
 	string curCulture		= "";	// the current culture
 	string curReligion	= "";	// the current religion
-	vector< pair<date, string> >::iterator cItr = cultureHistory.begin();	// the culture under consideration
-	while (cItr != cultureHistory.end() && cItr->first.year < cutoffDate.year)
+	vector< pair<date, string> >::const_iterator cItr = cultureHistory.begin();	// the culture under consideration
+	while (cItr != cultureHistory.end() && cItr->first.year < cutoffYear)
 	{
 		curCulture = cItr->second;
 		++cItr;
@@ -435,8 +423,8 @@ void EU4Province::buildPopRatios()
 		// no starting culture; use first settlement culture for starting pop even if it's after 1620
 		curCulture = cItr->second;
 	}
-	vector< pair<date, string> >::iterator rItr = religionHistory.begin();	// the religion under consideration
-	while (rItr != religionHistory.end() && rItr->first.year < cutoffDate.year)
+	vector< pair<date, string> >::const_iterator rItr = religionHistory.begin();	// the religion under consideration
+	while (rItr != religionHistory.end() && rItr->first.year < cutoffYear)
 	{
 		curReligion = rItr->second;
 		++rItr;
@@ -447,81 +435,37 @@ void EU4Province::buildPopRatios()
 		curReligion = rItr->second;
 	}
 
-	// build and scale historic culture-religion pairs
+	// build and scale historic culture-religion pairs, taking the culture and religion changes together in date order
 	EU4PopRatio pr;		// a pop ratio
 	pr.culture			= curCulture;
 	pr.religion			= curReligion;
 	pr.upperPopRatio	= 1.0;
 	pr.middlePopRatio	= 1.0;
 	pr.lowerPopRatio	= 1.0;
-	date cDate, rDate, lastLoopDate;	// the dates this culture dominated, this religion dominated, and the former relevant date
+	date lastLoopDate;	// the former relevant date
 	while (cItr != cultureHistory.end() || rItr != religionHistory.end())
 	{
-		if (cItr == cultureHistory.end())
-		{
-			cDate = date("2000.1.1");
-		}
-		else
-		{
-			cDate = cItr->first;
-		}
-		if (rItr == religionHistory.end())
-		{
-			rDate = date("2000.1.1");
-		}
-		else
-		{
-			rDate = rItr->first;
-		}
-		if (cDate < rDate)
-		{
-			decayPopRatios(lastLoopDate, cDate, pr);
-			popRatios.push_back(pr);
-			for (auto itr: popRatios)
-			{
-				itr.upperPopRatio		/= 2.0;
-				itr.middlePopRatio	/= 2.0;
-			}
-			pr.upperPopRatio	= 0.5;
-			pr.middlePopRatio	= 0.5;
-			pr.lowerPopRatio	= 0.0;
-			pr.culture			= cItr->second;
-			lastLoopDate		= cDate;
-			++cItr;
-		}
-		else if (cDate == rDate)
+		bool cultureChanges	= (cItr != cultureHistory.end()) && ((rItr == religionHistory.end()) || !(rItr->first < cItr->first));
+		bool religionChanges	= (rItr != religionHistory.end()) && ((cItr == cultureHistory.end()) || !(cItr->first < rItr->first));
+
+		// the current pop grows until the next culture change, whichever kind of change comes first
+		const date& cDate = (cItr != cultureHistory.end()) ? cItr->first : noMoreChangesDate;
+		decayPopRatios(lastLoopDate, cDate, pr);
+		popRatios.push_back(pr);
+		pr.upperPopRatio	= 0.5;
+		pr.middlePopRatio	= 0.5;
+		pr.lowerPopRatio	= 0.0;
+
+		if (cultureChanges)
 		{
-			// culture and religion change on the same day;
-			decayPopRatios(lastLoopDate, cDate, pr);
-			popRatios.push_back(pr);
-			for (auto itr: popRatios)
-			{
-				itr.upperPopRatio		/= 2.0;
-				itr.middlePopRatio	/= 2.0;
-			}
-			pr.upperPopRatio	= 0.5;
-			pr.middlePopRatio	= 0.5;
-			pr.lowerPopRatio	= 0.0;
-			pr.culture			= cItr->second;
-			pr.religion			= rItr->second;
-			lastLoopDate		= cDate;
+			pr.culture		= cItr->second;
+			lastLoopDate	= cItr->first;
 			++cItr;
-			++rItr;
 		}
-		else if (rDate < cDate)
+		if (religionChanges)
 		{
-			decayPopRatios(lastLoopDate, cDate, pr);
-			popRatios.push_back(pr);
-			for (auto itr: popRatios)
-			{
-				itr.upperPopRatio		/= 2.0;
-				itr.middlePopRatio	/= 2.0;
-			}
-			pr.upperPopRatio	= 0.5;
-			pr.middlePopRatio	= 0.5;
-			pr.lowerPopRatio	= 0.0;
-			pr.religion			= rItr->second;
-			lastLoopDate		= rDate;
+			pr.religion		= rItr->second;
+			lastLoopDate	= rItr->first;
 			++rItr;
 		}
 	}
@@ -534,7 +478,7 @@ void EU4Province::buildPopRatios()
 }
 
 
-void	EU4Province::decayPopRatios(date oldDate, date newDate, EU4PopRatio& currentPop)
+void	EU4Province::decayPopRatios(const date& oldDate, const date& newDate, EU4PopRatio& currentPop) const
 {
 	// quick out for initial state (no decay needed)
 	if (oldDate == date())
@@ -548,18 +492,8 @@ void	EU4Province::decayPopRatios(date oldDate, date newDate, EU4PopRatio& curren
 		return;
 	}
 
-	// drop all non-current pops by a total of .0025 per year, divided proportionally
-	double upperNonCurrentRatio	= (1.0 - currentPop.upperPopRatio);
-	double middleNonCurrentRatio	= (1.0 - currentPop.middlePopRatio);
-	double lowerNonCurrentRatio	= (1.0 - currentPop.lowerPopRatio);
-	for (auto itr: popRatios)
-	{
-		itr.upperPopRatio		-= .0025 * (newDate.year - oldDate.year) * itr.upperPopRatio	/ upperNonCurrentRatio;
-		itr.middlePopRatio	-= .0025 * (newDate.year - oldDate.year) * itr.middlePopRatio	/ middleNonCurrentRatio;
-		itr.lowerPopRatio		-= .0025 * (newDate.year - oldDate.year) * itr.lowerPopRatio	/ lowerNonCurrentRatio;
-	}
-	
 	// increase current pop by .0025 per year
+	// the earlier pops are left as they were recorded, so only the current one changes
 	currentPop.upperPopRatio	+= .0025 * (newDate.year - oldDate.year);
 	currentPop.middlePopRatio	+= .0025 * (newDate.year - oldDate.year);
 	currentPop.lowerPopRatio	+= .0025 * (newDate.year - oldDate.year);
@@ -50,9 +50,10 @@ class EU4Province {
 		void						addCore(string tag);
 		void						removeCore(string tag);
 		void						determineProvinceWeight();
+		void						buildPopRatios();
 
 		bool						wasColonised() const;
-		bool						wasInfidelConquest() const;
+		bool						wasInfidelConquest(vector<string>& warnings) const;
 		bool						hasBuilding(string building) const;
 		vector<EU4Country*>	getCores(const map<string, EU4Country*>& countries) const;
 		date						getLastPossessedDate(string tag) const;
@@ -64,7 +65,7 @@ class EU4Province {
 		EU4Country*				getOwner()				const { return owner; }
 		bool						getInHRE()				const { return inHRE; }
 		bool						isColony()				const { return colony; }
-		vector<EU4PopRatio>	getPopRatios()			const { return popRatios; }
+		const vector<EU4PopRatio>&	getPopRatios()	const { return popRatios; }
 		double					getTotalWeight()		const { return totalWeight; }
 		int						getNumDestV2Provs()	const { return numV2Provs; }
 
@@ -85,8 +86,7 @@ class EU4Province {
 
 	private:
 		void	checkBuilding(const Object* provinceObj, string building);
-		void	buildPopRatios();
-		void	decayPopRatios(date oldDate, date newDate, EU4PopRatio& currentPop);
+		void	decayPopRatios(const date& oldDate, const date& newDate, EU4PopRatio& currentPop) const;
 
 		vector<double>	getProvBuildingWeight()	const;
 		double			getTradeGoodWeight()		const;
@@ -26,6 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <fstream>
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
+#include "ParallelFor.h"
 #include "../Configuration.h"
 #include "../Mappers/CultureMapper.h"
 #include "../Mappers/EU4CultureGroupMapper.h"
@@ -33,6 +34,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "../Mappers/ReligionMapper.h"
 #include "Object.h"
 #include "ParadoxParserUTF8.h"
+#include "ParadoxParserVisitor.h"
 #include "EU4Province.h"
 #include "EU4Country.h"
 #include "EU4Diplomacy.h"
@@ -57,6 +59,7 @@ EU4World::EU4World(const string& EU4SaveFileName)
 	loadEndDate(EU4SaveObject);
 	loadHolyRomanEmperor(EU4SaveObject);
 	loadProvinces(EU4SaveObject);
+	buildProvincePopRatios();
 	loadCountries(EU4SaveObject);
 	loadRevolutionTarget(EU4SaveObject);
 	addProvinceInfoToCountries();
@@ -115,7 +118,7 @@ void EU4World::verifySave(const string& EU4SaveFileName)
 Object* EU4World::parseSave(const string& EU4SaveFileName)
 {
 	LOG(LogLevel::Info) << "Parsing save";
-	Object* obj = parser_UTF8::doParseFile(EU4SaveFileName.c_str());
+	Object* obj = parser_UTF8::doParseFile(EU4SaveFileName.c_str(), parser_core::parseMode::lazy);
 	if (obj == NULL)
 	{
 		LOG(LogLevel::Error) << "Could not parse file " << EU4SaveFileName;
@@ -247,7 +250,7 @@ void EU4World::loadEU4ModDirectory(map<string, string>& possibleMods)
 				if ((name != "") && (path != ""))
 				{
 					possibleMods.insert(make_pair(name, EU4DocumentsLoc + "/" + path));
-					Log(LogLevel::Debug) << "\t\tFound a mod named " << name << " claiming to be at " << EU4DocumentsLoc << "/" << path;
+					LOG(LogLevel::Debug) << "\t\tFound a mod named " << name << " claiming to be at " << EU4DocumentsLoc << "/" << path;
 				}
 			}
 		}
@@ -360,24 +363,40 @@ void EU4World::loadProvinces(const Object* EU4SaveObj)
 	vector<Object*> provincesObj = EU4SaveObj->getValue("provinces");					// the object holding the provinces
 	if (provincesObj.size() > 0)
 	{
-		vector<Object*> provincesLeaves = provincesObj[0]->getLeaves();		// the objects holding the individual provinces
-		for (unsigned int j = 0; j < provincesLeaves.size(); j++)
+		// the provinces are read from the save one at a time, and each one's objects are released once it has been built
+		parser_core::childStreamer provinceHandler([&](Object* provinceObj)
 		{
-			string keyProv = (provincesLeaves[j])->getKey();						// the key for the province
+			string keyProv = provinceObj->getKey();						// the key for the province
 
 			if (
 				(atoi(keyProv.c_str()) < 0) &&													// Check if key is a negative value (EU4 style)
 				(validProvinces.find(-1 * atoi(keyProv.c_str())) != validProvinces.end())	// check it's a valid province for this version of EU4
 				)
 			{
-				EU4Province* province = new EU4Province((provincesLeaves[j]));	// the province in our format
+				EU4Province* province = new EU4Province(provinceObj);	// the province in our format
 				provinces.insert(make_pair(province->getNum(), province));
 			}
-		}
+		});
+		parser_core::visitContents(provincesObj[0], provinceHandler);
 	}
 }
 
 
+void EU4World::buildProvincePopRatios()
+{
+	// each province's pop ratios only depend on its own history, so they're built in parallel
+	vector<EU4Province*> provinceList;
+	for (auto province: provinces)
+	{
+		provinceList.push_back(province.second);
+	}
+	Utils::parallelFor(provinceList.size(), [&provinceList](size_t i)
+	{
+		provinceList[i]->buildPopRatios();
+	});
+}
+
+
 map<int, int> EU4World::determineValidProvinces()
 {
 	// Use map/definition.csv to determine valid provinces
@@ -417,18 +436,18 @@ void EU4World::loadCountries(const Object* EU4SaveObj)
 	vector<Object*> countriesObj = EU4SaveObj->getValue("countries");				// the object holding the countries
 	if (countriesObj.size() > 0)
 	{
-		vector<Object*> countriesLeaves = countriesObj[0]->getLeaves();	// the objects holding the countries themselves
-		for (unsigned int j = 0; j < countriesLeaves.size(); j++)
+		// the countries are read from the save one at a time, and each one's objects are released once it has been built
+		parser_core::childStreamer countryHandler([&](Object* countryObj)
 		{
-			string keyCoun = countriesLeaves[j]->getKey();						// the key for this country
+			string keyCoun = countryObj->getKey();						// the key for this country
 
 			if ((keyCoun == "---") || (keyCoun == "REB") || (keyCoun == "PIR") || (keyCoun == "NAT"))
 			{
-				continue;
+				return;
 			}
 			else
 			{
-				EU4Country* country = new EU4Country(countriesLeaves[j], version);	// the country in our format
+				EU4Country* country = new EU4Country(countryObj, version);	// the country in our format
 				countries.insert(make_pair(country->getTag(), country));
 
 				// set HRE stuff
@@ -442,7 +461,8 @@ void EU4World::loadCountries(const Object* EU4SaveObj)
 					country->setEmperor(true);
 				}
 			}
-		}
+		});
+		parser_core::visitContents(countriesObj[0], countryHandler);
 	}
 }
 
@@ -710,6 +730,11 @@ void EU4World::setLocalisations()
 {
 	LOG(LogLevel::Info) << "Reading localisation";
 	EU4Localisation localisation;
+	for (auto country: countries)
+	{
+		localisation.AddRequiredKey(country.second->getTag());
+		localisation.AddRequiredKey(country.second->getTag() + "_ADJ");
+	}
 	localisation.ReadFromAllFilesInFolder(Configuration::getEU4Path() + "/localisation");
 	for (auto itr: Configuration::getEU4Mods())
 	{
@@ -897,7 +922,7 @@ void EU4World::checkAllEU4ReligionsMapped() const
 		auto Vic2Religion = religionMapper::getVic2Religion(EU4Religion.first);
 		if (Vic2Religion == "")
 		{
-			Log(LogLevel::Warning) << "No religion mapping for EU4 religion " << EU4Religion.first;
+			LOG(LogLevel::Warning) << "No religion mapping for EU4 religion " << EU4Religion.first;
 		}
 	}
 }
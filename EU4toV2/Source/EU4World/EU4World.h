@@ -44,7 +44,7 @@ class EU4World
 		EU4Province* getProvince(int provNum) const;
 
 		EU4Version* getVersion() const { return version; };
-		map<string, EU4Country*> getCountries() const { return countries; };
+		const map<string, EU4Country*>& getCountries() const { return countries; };
 		vector<EU4Agreement> getDiplomaticAgreements() const { return diplomacy->getAgreements(); };
 		double getWorldWeightSum() const { return worldWeightSum; };
 
@@ -65,6 +65,7 @@ class EU4World
 		void loadHolyRomanEmperor(const Object* EU4SaveObj);
 
 		void loadProvinces(const Object* EU4SaveObj);
+		void buildProvincePopRatios();
 		map<int, int> determineValidProvinces();
 
 		void loadCountries(const Object* EU4SaveObj);
@@ -25,6 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "Configuration.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
+#include "ParsedFileCache.h"
 #include "EU4World/EU4World.h"
 #include "V2World/V2World.h"
 
@@ -34,6 +35,8 @@ string getSaveFileName(const int argc, const char * argv[]);
 void ConvertEU4ToV2(const string& EU4SaveFileName);
 int main(const int argc, const char * argv[])
 {
+	Log::flushOnCrash();
+
 	try
 	{
 		LOG(LogLevel::Info) << "Converter version 1.0E";
@@ -76,6 +79,7 @@ void ConvertEU4ToV2(const string& EU4SaveFileName)
 	Configuration::getInstance();
 	setOutputName(EU4SaveFileName);
 	deleteExistingOutputFolder();
+	parser_cache::enable(Utils::getCurrentDirectory() + "/cache");
 
 	EU4World sourceWorld(EU4SaveFileName);
 	V2World destWorld(sourceWorld);
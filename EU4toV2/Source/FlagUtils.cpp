@@ -2,59 +2,200 @@
 #include "targa.h"
 
 #include "Log.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	// The same few base templates, emblems and overlord flags are used for many flags, so each is read from disk only once. Flags are
+	// composited into copies of the cached images, which are never changed.
+	typedef std::shared_ptr<const tga_image> decodedImage;
+
+	std::mutex decodedImagesMutex;
+	std::map<std::string, decodedImage> decodedImages;
+
+	decodedImage getDecodedImage(const std::string& path)
+	{
+		{
+			std::lock_guard<std::mutex> lock(decodedImagesMutex);
+			auto cached = decodedImages.find(path);
+			if (cached != decodedImages.end())
+			{
+				return cached->second;
+			}
+		}
+
+		tga_image* image = new tga_image;
+		if (0 != tga_read(image, path.c_str()))
+		{
+			delete image;
+			return nullptr;
+		}
+		decodedImage decoded(image, [](const tga_image* image) { tga_free_buffers(const_cast<tga_image*>(image)); delete image; });
+
+		std::lock_guard<std::mutex> lock(decodedImagesMutex);
+		return decodedImages.insert(std::make_pair(path, decoded)).first->second;
+	}
+
+	// A copy of a decoded image with its own pixels. The ID and colour map still belong to the decoded image.
+	struct imageCopy
+	{
+		tga_image image;
+		std::vector<uint8_t> pixels;
+
+		explicit imageCopy(const tga_image& source): image(source), pixels(source.image_data, source.image_data + source.width * source.height * source.pixel_depth / 8)
+		{
+			image.image_data = pixels.data();
+		}
+	};
+
+	// Whole rows can only be worked on directly in images stored left to right with a byte per channel
+	bool hasPlainRows(const tga_image& image)
+	{
+		return ((image.pixel_depth == 24) || (image.pixel_depth == 32)) && !tga_is_right_to_left(&image);
+	}
+
+	// Recolours a row of a custom flag base from its red, green and blue masks, blends the emblem row over it, and packs the result back
+	// into the base. This is the same integer arithmetic as the per-pixel version, split into passes over plain arrays that compilers can
+	// vectorise. emblemRow is null if the emblem doesn't reach this row.
+	void compositeCustomRow(uint8_t* baseRow, unsigned int baseBytesPerPixel, const uint8_t* emblemRow, unsigned int emblemBytesPerPixel, unsigned int emblemWidth, unsigned int width, int y, const FlagColour& c1, const FlagColour& c2, const FlagColour& c3, std::vector<int>& tr, std::vector<int>& tg, std::vector<int>& tb)
+	{
+		for (unsigned int x = 0; x < width; x++)
+		{
+			int z = 255 - baseRow[x * baseBytesPerPixel + 0];
+			int m = 255 - baseRow[x * baseBytesPerPixel + 1];
+			int c = 255 - baseRow[x * baseBytesPerPixel + 2];
+			tr[x] = (m*c1.r + c*c2.r + z*c3.r) / 255;
+			tg[x] = (m*c1.g + c*c2.g + z*c3.g) / 255;
+			tb[x] = (m*c1.b + c*c2.b + z*c3.b) / 255;
+		}
+
+		unsigned int blendedWidth = (emblemRow != nullptr) ? std::min(width, emblemWidth) : 0;
+		for (unsigned int x = 0; x < blendedWidth; x++)
+		{
+			int overlayBlue = emblemRow[x * emblemBytesPerPixel + 0];
+			int overlayGreen = emblemRow[x * emblemBytesPerPixel + 1];
+			int overlayRed = emblemRow[x * emblemBytesPerPixel + 2];
+			int overlayAlpha = (emblemBytesPerPixel == 4) ? emblemRow[x * emblemBytesPerPixel + 3] : 0;
+			tr[x] = (overlayRed * overlayAlpha / 255) + ((tr[x] * (255 - overlayAlpha)) / 255);
+			tg[x] = (overlayGreen * overlayAlpha / 255) + ((tg[x] * (255 - overlayAlpha)) / 255);
+			tb[x] = (overlayBlue * overlayAlpha / 255) + ((tb[x] * (255 - overlayAlpha)) / 255);
+		}
+		for (unsigned int x = blendedWidth; x < width; x++)
+		{
+			LOG(LogLevel::Info) << x << " " << y;
+		}
+
+		for (unsigned int x = 0; x < width; x++)
+		{
+			baseRow[x * baseBytesPerPixel + 0] = static_cast<uint8_t>(tb[x]);
+			baseRow[x * baseBytesPerPixel + 1] = static_cast<uint8_t>(tg[x]);
+			baseRow[x * baseBytesPerPixel + 2] = static_cast<uint8_t>(tr[x]);
+		}
+		if (baseBytesPerPixel == 4)
+		{
+			for (unsigned int x = 0; x < width; x++)
+			{
+				baseRow[x * 4 + 3] = 255;
+			}
+		}
+	}
+
+	// Shrinks two rows of the overlord's flag into a row of the colonial flag's corner, averaging each two by two block
+	void compositeColonialRow(uint8_t* baseRow, unsigned int baseBytesPerPixel, const uint8_t* cornerRow1, const uint8_t* cornerRow2, unsigned int cornerBytesPerPixel, unsigned int width)
+	{
+		for (unsigned int x = 0; x < width; x++)
+		{
+			const uint8_t* samples[4] = {
+				cornerRow1 + (2 * x) * cornerBytesPerPixel,
+				cornerRow1 + ((2 * x) + 1) * cornerBytesPerPixel,
+				cornerRow2 + (2 * x) * cornerBytesPerPixel,
+				cornerRow2 + ((2 * x) + 1) * cornerBytesPerPixel
+			};
+
+			int tb = 0, tg = 0, tr = 0;
+			for (int px = 0; px < 4; px++)
+			{
+				tb += samples[px][0] / 4; tg += samples[px][1] / 4; tr += samples[px][2] / 4;
+			}
+
+			baseRow[x * baseBytesPerPixel + 0] = static_cast<uint8_t>(tb);
+			baseRow[x * baseBytesPerPixel + 1] = static_cast<uint8_t>(tg);
+			baseRow[x * baseBytesPerPixel + 2] = static_cast<uint8_t>(tr);
+			if (baseBytesPerPixel == 4)
+			{
+				baseRow[x * 4 + 3] = 255;
+			}
+		}
+	}
+}
 
 bool CreateColonialFlag(std::string colonialOverlordPath, std::string colonialBasePath, std::string targetPath)
 {
 	tga_result res;
 
-	tga_image ColonialBase;
-	tga_image Corner;
-	
-	res = tga_read(&ColonialBase, colonialBasePath.c_str());
-	if (0 != res)
+	decodedImage decodedBase = getDecodedImage(colonialBasePath);
+	if (!decodedBase)
 	{
 		LOG(LogLevel::Error) << "Failed to create colonial flag: could not open " << colonialBasePath;
 		return false;
 	}
 
-	res = tga_read(&Corner, colonialOverlordPath.c_str());
-	if (0 != res)
+	decodedImage decodedCorner = getDecodedImage(colonialOverlordPath);
+	if (!decodedCorner)
 	{
 		LOG(LogLevel::Error) << "Failed to create colonial flag: could not open " << colonialOverlordPath;
 		return false;
 	}
 
-	for (int y = 0; y < 31; y++)
+	imageCopy baseCopy(*decodedBase);
+	tga_image& ColonialBase = baseCopy.image;
+	const tga_image& Corner = *decodedCorner;
+
+	if (hasPlainRows(ColonialBase) && hasPlainRows(Corner) && (ColonialBase.width >= 45) && (ColonialBase.height >= 31) && (Corner.width >= 90) && (Corner.height >= 62))
 	{
-		for (int x = 0; x < 45; x++)
+		for (int y = 0; y < 31; y++)
 		{
-			uint8_t *targetAddress = tga_find_pixel(&ColonialBase, x, y);
-	
-			uint8_t* sample[4];
-			sample[0] = tga_find_pixel(&Corner, 2 * x, 2 * y);
-			sample[1] = tga_find_pixel(&Corner, (2 * x) + 1, 2 * y);
-			sample[2] = tga_find_pixel(&Corner, 2 * x, (2 * y) + 1);
-			sample[3] = tga_find_pixel(&Corner, (2 * x) + 1, (2 * y) + 1);
-	
-			uint8_t b = 0, g = 0, r = 0;
-			int tb = 0, tg = 0, tr = 0;
-
-			for (int px = 0; px < 4; px++)
+			compositeColonialRow(tga_find_pixel(&ColonialBase, 0, y), ColonialBase.pixel_depth / 8, tga_find_pixel(&Corner, 0, 2 * y), tga_find_pixel(&Corner, 0, (2 * y) + 1), Corner.pixel_depth / 8, 45);
+		}
+	}
+	else
+	{
+		for (int y = 0; y < 31; y++)
+		{
+			for (int x = 0; x < 45; x++)
 			{
-				res = tga_unpack_pixel(sample[px], Corner.pixel_depth, &b, &g, &r, NULL);
+				uint8_t *targetAddress = tga_find_pixel(&ColonialBase, x, y);
+
+				uint8_t* sample[4];
+				sample[0] = tga_find_pixel(&Corner, 2 * x, 2 * y);
+				sample[1] = tga_find_pixel(&Corner, (2 * x) + 1, 2 * y);
+				sample[2] = tga_find_pixel(&Corner, 2 * x, (2 * y) + 1);
+				sample[3] = tga_find_pixel(&Corner, (2 * x) + 1, (2 * y) + 1);
+
+				uint8_t b = 0, g = 0, r = 0;
+				int tb = 0, tg = 0, tr = 0;
+
+				for (int px = 0; px < 4; px++)
+				{
+					res = tga_unpack_pixel(sample[px], Corner.pixel_depth, &b, &g, &r, NULL);
+					if (0 != res)
+					{
+						LOG(LogLevel::Error) << "Failed to create colonial flag: could not read pixel data";
+						return false;
+					}
+					tb += b / 4; tg += g / 4; tr += r / 4;
+				}
+
+				res = tga_pack_pixel(targetAddress, ColonialBase.pixel_depth, tb, tg, tr, 255);
 				if (0 != res)
 				{
-					LOG(LogLevel::Error) << "Failed to create colonial flag: could not read pixel data";
+					LOG(LogLevel::Error) << "Failed to create colonial flag: could not write pixel data";
 					return false;
 				}
-				tb += b / 4; tg += g / 4; tr += r / 4;
-			}
-	
-			res = tga_pack_pixel(targetAddress, ColonialBase.pixel_depth, tb, tg, tr, 255);
-			if (0 != res)
-			{
-				LOG(LogLevel::Error) << "Failed to create colonial flag: could not write pixel data";
-				return false;
 			}
 		}
 	}
@@ -72,78 +213,90 @@ bool CreateCustomFlag(FlagColour c1, FlagColour c2, FlagColour c3, std::string e
 {
 	tga_result res;
 
-	tga_image base;
-	tga_image emblem;
-
-	res = tga_read(&base, basePath.c_str());
-	if (0 != res)
+	decodedImage decodedBase = getDecodedImage(basePath);
+	if (!decodedBase)
 	{
 		LOG(LogLevel::Error) << "Failed to create custom flag: could not open " << basePath;
 		return false;
 	}
 
-	res = tga_read(&emblem, emblemPath.c_str());
-	if (0 != res)
+	decodedImage decodedEmblem = getDecodedImage(emblemPath);
+	if (!decodedEmblem)
 	{
 		LOG(LogLevel::Error) << "Failed to create custom flag: could not open " << emblemPath;
 		return false;
 	}
 
-	for (int y = 0; y < base.height; y++)
+	imageCopy baseCopy(*decodedBase);
+	tga_image& base = baseCopy.image;
+	const tga_image& emblem = *decodedEmblem;
+
+	if (hasPlainRows(base) && hasPlainRows(emblem))
+	{
+		std::vector<int> tr(base.width), tg(base.width), tb(base.width);
+		for (int y = 0; y < base.height; y++)
+		{
+			compositeCustomRow(tga_find_pixel(&base, 0, y), base.pixel_depth / 8, tga_find_pixel(&emblem, 0, y), emblem.pixel_depth / 8, emblem.width, base.width, y, c1, c2, c3, tr, tg, tb);
+		}
+	}
+	else
 	{
-		for (int x = 0; x < base.width; x++)
+		for (int y = 0; y < base.height; y++)
 		{
-			uint8_t *targetAddress = tga_find_pixel(&base, x, y);
-			
-			uint8_t r = 0, g = 0, b = 0;
-			
-			res = tga_unpack_pixel(targetAddress, base.pixel_depth, &b, &g, &r, NULL);
-			if (0 != res)
+			for (int x = 0; x < base.width; x++)
 			{
-				LOG(LogLevel::Error) << "Failed to create custom flag: could not read pixel data";
-				return false;
-			}
+				uint8_t *targetAddress = tga_find_pixel(&base, x, y);
 
-			uint8_t c = ~r;
-			uint8_t m = ~g;
-			uint8_t z = ~b;
-			
-			int tr = int(m*c1.r) + int(c*c2.r) + int(z*c3.r);
-			int tg = int(m*c1.g) + int(c*c2.g) + int(z*c3.g);
-			int tb = int(m*c1.b) + int(c*c2.b) + int(z*c3.b);
+				uint8_t r = 0, g = 0, b = 0;
 
-			tr /= 255;
-			tg /= 255;
-			tb /= 255;
+				res = tga_unpack_pixel(targetAddress, base.pixel_depth, &b, &g, &r, NULL);
+				if (0 != res)
+				{
+					LOG(LogLevel::Error) << "Failed to create custom flag: could not read pixel data";
+					return false;
+				}
 
-			uint8_t or = 0, og = 0, ob = 0, oa = 0;
+				uint8_t c = ~r;
+				uint8_t m = ~g;
+				uint8_t z = ~b;
 
-			uint8_t *targetOverlayAddress = tga_find_pixel(&emblem, x, y);
-			if (targetOverlayAddress)
-			{
-				res = tga_unpack_pixel(targetOverlayAddress, emblem.pixel_depth, &ob, &og, &or, &oa);
+				int tr = int(m*c1.r) + int(c*c2.r) + int(z*c3.r);
+				int tg = int(m*c1.g) + int(c*c2.g) + int(z*c3.g);
+				int tb = int(m*c1.b) + int(c*c2.b) + int(z*c3.b);
+
+				tr /= 255;
+				tg /= 255;
+				tb /= 255;
+
+				uint8_t or = 0, og = 0, ob = 0, oa = 0;
+
+				uint8_t *targetOverlayAddress = tga_find_pixel(&emblem, x, y);
+				if (targetOverlayAddress)
+				{
+					res = tga_unpack_pixel(targetOverlayAddress, emblem.pixel_depth, &ob, &og, &or, &oa);
+					if (0 != res)
+					{
+						LOG(LogLevel::Error) << "Failed to create custom flag: could not read pixel data";
+						return false;
+					}
+
+					tr = (or*oa / 255) + ((tr *(255 - oa)) / 255);
+					tg = (og*oa / 255) + ((tg *(255 - oa)) / 255);
+					tb = (ob*oa / 255) + ((tb *(255 - oa)) / 255);
+				}
+				else
+				{
+					LOG(LogLevel::Info) << x << " " << y;
+				}
+
+				res = tga_pack_pixel(targetAddress, base.pixel_depth, tb, tg, tr, 255);
 				if (0 != res)
 				{
-					LOG(LogLevel::Error) << "Failed to create custom flag: could not read pixel data";
+					LOG(LogLevel::Error) << "Failed to create custom flag: could not write pixel data";
 					return false;
 				}
-				
-				tr = (or*oa / 255) + ((tr *(255 - oa)) / 255);
-				tg = (og*oa / 255) + ((tg *(255 - oa)) / 255);
-				tb = (ob*oa / 255) + ((tb *(255 - oa)) / 255);
-			}
-			else
-			{
-				LOG(LogLevel::Info) << x << " " << y;
-			}
 
-			res = tga_pack_pixel(targetAddress, base.pixel_depth, tb, tg, tr, 255);
-			if (0 != res)
-			{
-				LOG(LogLevel::Error) << "Failed to create custom flag: could not write pixel data";
-				return false;
 			}
-
 		}
 	}
 
@@ -22,7 +22,6 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 #include "CultureMapper.h"
-#include "EU4RegionMapper.h"
 #include "Log.h"
 #include "ParadoxParserUTF8.h"
 
@@ -65,136 +64,18 @@ cultureMapper::cultureMapper()
 
 void cultureMapper::initCultureMap(Object* cultureMapObj, Object* slaveCultureMapObj)
 {
-	for (auto rule: cultureMapObj->getLeaves())
-	{
-		vector<cultureStruct> newRules = createNewRules(rule);
-		for (auto newRule: newRules)
-		{
-			cultureMap.push_back(newRule);
-		}
-	}
-
-	for (auto rule: slaveCultureMapObj->getLeaves())
-	{
-		vector<cultureStruct> newRules = createNewRules(rule);
-		for (auto newRule: newRules)
-		{
-			slaveCultureMap.push_back(newRule);
-		}
-	}
+	cultureMap.addRules(cultureMapObj);
+	slaveCultureMap.addRules(slaveCultureMapObj);
 }
 
 
-vector<cultureStruct> cultureMapper::createNewRules(Object* ruleObj)
+bool cultureMapper::CultureMatch(const string& srcCulture, string& dstCulture, const string& religion, int EU4Province, const string& ownerTag) const
 {
-	vector<cultureStruct> newRules;
-
-	vector<string> srcCultures;
-	string dstCulture;
-	map<string, string> distinguishers;
-	for (auto item: ruleObj->getLeaves())
-	{
-		if (item->getKey() == "v2")
-		{
-			dstCulture = item->getLeaf();
-		}
-		else if (item->getKey() == "eu4")
-		{
-			srcCultures.push_back(item->getLeaf());
-		}
-		else
-		{
-			distinguishers.insert(make_pair(item->getKey(), item->getLeaf()));
-		}
-	}
-
-	for (auto srcCulture: srcCultures)
-	{
-		cultureStruct rule;
-		rule.srcCulture = srcCulture;
-		rule.dstCulture = dstCulture;
-		rule.distinguishers = distinguishers;
-		newRules.push_back(rule);
-	}
-
-	return newRules;
+	return cultureMap.match(srcCulture, dstCulture, religion, EU4Province, ownerTag);
 }
 
 
-bool cultureMapper::CultureMatch(const string& srcCulture, string& dstCulture, const string& religion, int EU4Province, const string& ownerTag)
+bool cultureMapper::SlaveCultureMatch(const string& srcCulture, string& dstCulture, const string& religion, int EU4Province, const string& ownerTag) const
 {
-	for (auto cultureMapping: cultureMap)
-	{
-		if (cultureMapping.srcCulture == srcCulture)
-		{
-			if (distinguishersMatch(cultureMapping.distinguishers, religion, EU4Province, ownerTag))
-			{
-				dstCulture = cultureMapping.dstCulture;
-				return true;
-			}
-		}
-	}
-
-	return false;
-}
-
-
-bool cultureMapper::SlaveCultureMatch(const string& srcCulture, string& dstCulture, const string& religion, int EU4Province, const string& ownerTag)
-{
-	for (auto cultureMapping: slaveCultureMap)
-	{
-		if (cultureMapping.srcCulture == srcCulture)
-		{
-			if (distinguishersMatch(cultureMapping.distinguishers, religion, EU4Province, ownerTag))
-			{
-				dstCulture = cultureMapping.dstCulture;
-				return true;
-			}
-		}
-	}
-
-	return false;
-}
-
-
-bool cultureMapper::distinguishersMatch(const map<string, string>& distinguishers, const string& religion, int EU4Province, const string& ownerTag)
-{
-	for (auto currentDistinguisher: distinguishers)
-	{
-		if (currentDistinguisher.first == "owner")
-		{
-			if (ownerTag != currentDistinguisher.second)
-			{
-				return false;
-			}
-		}
-		else if (currentDistinguisher.first == "religion")
-		{
-			if (religion != currentDistinguisher.second)
-			{
-				return false;
-			}
-		}
-		else if (currentDistinguisher.first == "region")
-		{
-			if (!EU4RegionMapper::provinceInRegion(EU4Province, currentDistinguisher.second))
-			{
-				return false;
-			}
-		}
-		else if (currentDistinguisher.first == "provinceid")
-		{
-			if (stoi(currentDistinguisher.second) != EU4Province)
-			{
-				return false;
-			}
-		}
-		else
-		{
-			LOG(LogLevel::Warning) << "Unhandled distinguisher type in culture rules: " << currentDistinguisher.first;
-			return false;
-		}
-	}
-
-	return true;
+	return slaveCultureMap.match(srcCulture, dstCulture, religion, EU4Province, ownerTag);
 }
\ No newline at end of file
@@ -26,9 +26,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
-#include <map>
+#include "MappingRules.h"
 #include <string>
-#include <vector>
 using namespace std;
 
 
@@ -37,15 +36,6 @@ class Object;
 
 
 
-typedef struct
-{
-	string srcCulture;
-	string dstCulture;
-	map<string, string> distinguishers;	// type, details
-} cultureStruct;
-
-
-
 class cultureMapper
 {
 	public:
@@ -72,14 +62,12 @@ class cultureMapper
 
 		cultureMapper();
 		void initCultureMap(Object* cultureMapObj, Object* slaveCultureMapObj);
-		vector<cultureStruct> createNewRules(Object* ruleObj);
 
-		bool CultureMatch(const string& srcCulture, string& dstCulture, const string& religion = "", int EU4Province = -1, const string& ownerTag = "");
-		bool SlaveCultureMatch(const string& srcCulture, string& dstCulture, const string& religion = "", int EU4Province = -1, const string& ownerTag = "");
-		bool distinguishersMatch(const map<string, string>& distinguishers, const string& religion = "", int EU4Province = -1, const string& ownerTag = "");
+		bool CultureMatch(const string& srcCulture, string& dstCulture, const string& religion = "", int EU4Province = -1, const string& ownerTag = "") const;
+		bool SlaveCultureMatch(const string& srcCulture, string& dstCulture, const string& religion = "", int EU4Province = -1, const string& ownerTag = "") const;
 
-		vector<cultureStruct> cultureMap;
-		vector<cultureStruct> slaveCultureMap;
+		mappingRules cultureMap;
+		mappingRules slaveCultureMap;
 };
 
 
@@ -210,22 +210,7 @@ map<string, vector<int>> EU4RegionMapper::getAreaToProvincesMapping(Object* area
 
 
 bool EU4RegionMapper::ProvinceInRegion(int province, const string& region)
-{
-	auto regions = getRegions(province);
-	return (regions.count(region) > 0);
-}
-
-
-set<string> EU4RegionMapper::getRegions(int province)
 {
 	auto mapping = EU4RegionsMap.find(province);
-	if (mapping != EU4RegionsMap.end())
-	{
-		return mapping->second;
-	}
-	else
-	{
-		set<string> empty;
-		return empty;
-	}
+	return ((mapping != EU4RegionsMap.end()) && (mapping->second.count(region) > 0));
 }
\ No newline at end of file
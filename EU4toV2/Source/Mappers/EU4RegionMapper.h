@@ -41,6 +41,11 @@ class Object;
 class EU4RegionMapper
 {
 	public:
+		static void createSelf()
+		{
+			getInstance();
+		}
+
 		static bool provinceInRegion(int province, const string& region)
 		{
 			return getInstance()->ProvinceInRegion(province, region);
@@ -65,7 +70,6 @@ class EU4RegionMapper
 		map<string, vector<int>> getAreaToProvincesMapping(Object* areasObj);
 
 		bool ProvinceInRegion(int province, const string& region);
-		set<string> getRegions(int province);
 
 		map<int, set<string>> EU4RegionsMap;
 };
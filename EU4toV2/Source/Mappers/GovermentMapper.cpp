@@ -25,8 +25,6 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "Log.h"
 #include "Object.h"
 #include "ParadoxParserUTF8.h"
-#include <vector>
-using namespace std;
 
 
 
@@ -51,44 +49,16 @@ governmentMapper::governmentMapper()
 
 void governmentMapper::initGovernmentMap(Object* obj)
 {
-	for (auto rule: obj->getLeaves())
-	{
-		processRule(rule);
-	}
+	governmentMap.addRules(obj);
 }
 
 
-void governmentMapper::processRule(Object* rule)
+string governmentMapper::MatchGovernment(const string& sourceGovernment) const
 {
 	string dstGovernment;
-	vector<string> sourceGovernments;
-
-	for (auto item: rule->getLeaves())
-	{
-		if (item->getKey() == "v2")
-		{
-			dstGovernment = item->getLeaf();
-		}
-		if (item->getKey() == "eu4")
-		{
-			sourceGovernments.push_back(item->getLeaf());
-		}
-	}
-
-	for (auto sourceGovernment: sourceGovernments)
-	{
-		governmentMap.insert(make_pair(sourceGovernment, dstGovernment));
-	}
-}
-
-
-
-string governmentMapper::MatchGovernment(const string& sourceGovernment)
-{
-	auto mapping = governmentMap.find(sourceGovernment);
-	if (mapping != governmentMap.end())
+	if (governmentMap.match(sourceGovernment, dstGovernment))
 	{
-		return mapping->second;
+		return dstGovernment;
 	}
 	else
 	{
@@ -26,7 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
-#include <map>
+#include "MappingRules.h"
 #include <string>
 using namespace std;
 
@@ -57,11 +57,10 @@ class governmentMapper
 
 		governmentMapper();
 		void initGovernmentMap(Object* obj);
-		void processRule(Object* obj);
 
-		string MatchGovernment(const string& sourceGovernment);
+		string MatchGovernment(const string& sourceGovernment) const;
 
-		map<string, string> governmentMap;
+		mappingRules governmentMap;
 };
 
 
@@ -0,0 +1,214 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#include "MappingRules.h"
+#include "EU4RegionMapper.h"
+#include "Log.h"
+#include "Object.h"
+#include <map>
+
+
+
+void mappingRules::addRules(Object* rulesObj)
+{
+	for (auto rule: rulesObj->getLeaves())
+	{
+		addRule(rule);
+	}
+
+	unique_lock<shared_timed_mutex> lock(cacheLock);
+	matchCache.clear();
+}
+
+
+void mappingRules::addRule(Object* ruleObj)
+{
+	vector<string> sources;
+	rule newRule;
+	map<string, string> distinguishers;
+	for (auto item: ruleObj->getLeaves())
+	{
+		if (item->getKey() == "v2")
+		{
+			newRule.destination = item->getLeaf();
+		}
+		else if (item->getKey() == "eu4")
+		{
+			sources.push_back(item->getLeaf());
+		}
+		else
+		{
+			distinguishers.insert(make_pair(item->getKey(), item->getLeaf()));
+		}
+	}
+
+	for (auto currentDistinguisher: distinguishers)
+	{
+		distinguisher newDistinguisher;
+		newDistinguisher.value = currentDistinguisher.second;
+		newDistinguisher.province = -1;
+		if (currentDistinguisher.first == "owner")
+		{
+			newDistinguisher.type = distinguisherType::owner;
+		}
+		else if (currentDistinguisher.first == "religion")
+		{
+			newDistinguisher.type = distinguisherType::religion;
+		}
+		else if (currentDistinguisher.first == "region")
+		{
+			newDistinguisher.type = distinguisherType::region;
+			EU4RegionMapper::createSelf();	// load the regions now, as rules may later be matched from several threads
+		}
+		else if (currentDistinguisher.first == "provinceid")
+		{
+			newDistinguisher.type = distinguisherType::province;
+			newDistinguisher.province = stoi(currentDistinguisher.second);
+		}
+		else
+		{
+			LOG(LogLevel::Warning) << "Unhandled distinguisher type in mapping rules: " << currentDistinguisher.first;
+			newDistinguisher.type = distinguisherType::unhandled;
+		}
+		newRule.distinguishers.push_back(newDistinguisher);
+	}
+
+	for (auto source: sources)
+	{
+		rules[source].push_back(newRule);
+		if (newRule.distinguishers.size() > 0)
+		{
+			hasDistinguishers[source] = true;
+		}
+	}
+}
+
+
+bool mappingRules::match(const string& source, string& destination, const string& religion, int EU4Province, const string& ownerTag) const
+{
+	auto sourceRules = rules.find(source);
+	if (sourceRules == rules.end())
+	{
+		return false;
+	}
+
+	const string* matchedDestination;
+	if (hasDistinguishers.count(source) == 0)
+	{
+		matchedDestination = &sourceRules->second.front().destination;
+	}
+	else
+	{
+		matchKey key = { &sourceRules->first, religion, EU4Province, ownerTag };
+
+		shared_lock<shared_timed_mutex> readLock(cacheLock);
+		auto cachedMatch = matchCache.find(key);
+		if (cachedMatch != matchCache.end())
+		{
+			matchedDestination = cachedMatch->second;
+		}
+		else
+		{
+			readLock.unlock();
+			matchedDestination = findDestination(sourceRules->second, religion, EU4Province, ownerTag);
+			unique_lock<shared_timed_mutex> writeLock(cacheLock);
+			matchCache.insert(make_pair(move(key), matchedDestination));
+		}
+	}
+
+	if (matchedDestination == nullptr)
+	{
+		return false;
+	}
+	destination = *matchedDestination;
+	return true;
+}
+
+
+bool mappingRules::matchKey::operator==(const matchKey& other) const
+{
+	return (source == other.source) && (province == other.province) && (religion == other.religion) && (ownerTag == other.ownerTag);
+}
+
+
+size_t mappingRules::matchKeyHash::operator()(const matchKey& key) const
+{
+	size_t hash = std::hash<const string*>()(key.source);
+	hash = hash * 31 + std::hash<string>()(key.religion);
+	hash = hash * 31 + std::hash<int>()(key.province);
+	hash = hash * 31 + std::hash<string>()(key.ownerTag);
+	return hash;
+}
+
+
+const string* mappingRules::findDestination(const vector<rule>& sourceRules, const string& religion, int EU4Province, const string& ownerTag) const
+{
+	for (auto& sourceRule: sourceRules)
+	{
+		if (distinguishersMatch(sourceRule.distinguishers, religion, EU4Province, ownerTag))
+		{
+			return &sourceRule.destination;
+		}
+	}
+
+	return nullptr;
+}
+
+
+bool mappingRules::distinguishersMatch(const vector<distinguisher>& distinguishers, const string& religion, int EU4Province, const string& ownerTag) const
+{
+	for (auto& currentDistinguisher: distinguishers)
+	{
+		switch (currentDistinguisher.type)
+		{
+			case distinguisherType::owner:
+				if (ownerTag != currentDistinguisher.value)
+				{
+					return false;
+				}
+				break;
+			case distinguisherType::religion:
+				if (religion != currentDistinguisher.value)
+				{
+					return false;
+				}
+				break;
+			case distinguisherType::region:
+				if (!EU4RegionMapper::provinceInRegion(EU4Province, currentDistinguisher.value))
+				{
+					return false;
+				}
+				break;
+			case distinguisherType::province:
+				if (currentDistinguisher.province != EU4Province)
+				{
+					return false;
+				}
+				break;
+			default:
+				return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,91 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef MAPPING_RULES_H
+#define MAPPING_RULES_H
+
+
+
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+
+
+class Object;
+
+
+
+// The links from a mapping file such as cultureMap.txt, indexed by source name. Each link maps one or more eu4 names to a v2 name, and
+// any other items in it are distinguishers limiting it to an owner, religion, region or province. The first link listed that fits is used.
+class mappingRules
+{
+	public:
+		void addRules(Object* rulesObj);
+		bool match(const string& source, string& destination, const string& religion = "", int EU4Province = -1, const string& ownerTag = "") const;
+
+	private:
+		enum class distinguisherType { owner, religion, region, province, unhandled };
+		struct distinguisher
+		{
+			distinguisherType	type;
+			string				value;		// the owner, religion or region required
+			int					province;	// the province required
+		};
+		struct rule
+		{
+			string					destination;
+			vector<distinguisher>	distinguishers;
+		};
+
+		// A source is kept as the address of its name in rules, which doesn't move as rules are added
+		struct matchKey
+		{
+			const string*	source;
+			string			religion;
+			int				province;
+			string			ownerTag;
+
+			bool operator==(const matchKey& other) const;
+		};
+		struct matchKeyHash
+		{
+			size_t operator()(const matchKey& key) const;
+		};
+
+		void addRule(Object* ruleObj);
+		const string* findDestination(const vector<rule>& sourceRules, const string& religion, int EU4Province, const string& ownerTag) const;
+		bool distinguishersMatch(const vector<distinguisher>& distinguishers, const string& religion, int EU4Province, const string& ownerTag) const;
+
+		unordered_map<string, vector<rule>>	rules;					// the rules for each source, in the order they're listed
+		unordered_map<string, bool>			hasDistinguishers;	// whether a source has any rules that depend on where it's being matched
+
+		mutable shared_timed_mutex													cacheLock;	// guards the match cache, which many threads may read at once
+		mutable unordered_map<matchKey, const string*, matchKeyHash>	matchCache;	// earlier results for sources with distinguishers
+};
+
+
+
+#endif // MAPPING_RULES_H
@@ -55,39 +55,16 @@ religionMapper::religionMapper()
 
 void religionMapper::initReligionMap(Object* obj)
 {
-	vector<Object*> rules = obj->getLeaves();
-
-	for (auto rule: rules)
-	{
-		string Vic2Religion;
-		vector<string> EU4Religions;
-
-		for (auto ruleItem: rule->getLeaves())
-		{
-			if (ruleItem->getKey() == "v2")
-			{
-				Vic2Religion = ruleItem->getLeaf();
-			}
-			if (ruleItem->getKey() == "eu4")
-			{
-				EU4Religions.push_back(ruleItem->getLeaf());
-			}
-		}
-
-		for (auto EU4Religion: EU4Religions)
-		{
-			EU4ToVic2ReligionMap.insert(make_pair(EU4Religion, Vic2Religion));
-		}
-	}
+	EU4ToVic2ReligionMap.addRules(obj);
 }
 
 
-string religionMapper::GetVic2Religion(const string& EU4Religion)
+string religionMapper::GetVic2Religion(const string& EU4Religion) const
 {
-	auto mapping = EU4ToVic2ReligionMap.find(EU4Religion);
-	if (mapping != EU4ToVic2ReligionMap.end())
+	string Vic2Religion;
+	if (EU4ToVic2ReligionMap.match(EU4Religion, Vic2Religion))
 	{
-		return mapping->second;
+		return Vic2Religion;
 	}
 	else
 	{
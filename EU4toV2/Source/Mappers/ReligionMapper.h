@@ -26,7 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
-#include <map>
+#include "MappingRules.h"
 #include <string>
 using namespace std;
 
@@ -57,9 +57,9 @@ class religionMapper
 		religionMapper();
 		void initReligionMap(Object* obj);
 
-		string GetVic2Religion(const string& EU4Religion);
+		string GetVic2Religion(const string& EU4Religion) const;
 
-		map<string, string> EU4ToVic2ReligionMap;
+		mappingRules EU4ToVic2ReligionMap;
 };
 
 
@@ -1300,7 +1300,7 @@ void V2Country::addRelation(V2Relations* newRelation)
 
 void V2Country::absorbVassal(V2Country* vassal)
 {
-	Log(LogLevel::Debug) << "\t" << tag << " is absorbing " << vassal->getTag();
+	LOG(LogLevel::Debug) << "\t" << tag << " is absorbing " << vassal->getTag();
 
 	// change province ownership and add owner cores if needed
 	map<int, V2Province*> vassalProvinces = vassal->getProvinces();
@@ -2088,8 +2088,8 @@ int V2Country::addRegimentToArmy(V2Army* army, RegimentCategory rc, map<int, V2P
 		}
 
 		// Armies need to be associated with pops
-		V2Pop* soldierPop = homeProvince->getSoldierPopForArmy();
-		if (NULL == soldierPop)
+		int soldierPop = homeProvince->getSoldierPopForArmy();
+		if (soldierPop == -1)
 		{
 			// if the old home province was colonized and can't support the unit, try turning it into an "expeditionary" army
 			if (homeProvince->wasColony())
@@ -2097,8 +2097,8 @@ int V2Country::addRegimentToArmy(V2Army* army, RegimentCategory rc, map<int, V2P
 				V2Province* expSender = getProvinceForExpeditionaryArmy();
 				if (expSender)
 				{
-					V2Pop* expSoldierPop = expSender->getSoldierPopForArmy();
-					if (NULL != expSoldierPop)
+					int expSoldierPop = expSender->getSoldierPopForArmy();
+					if (expSoldierPop != -1)
 					{
 						homeProvince = expSender;
 						soldierPop = expSoldierPop;
@@ -2106,7 +2106,7 @@ int V2Country::addRegimentToArmy(V2Army* army, RegimentCategory rc, map<int, V2P
 				}
 			}
 		}
-		if (NULL == soldierPop)
+		if (soldierPop == -1)
 		{
 			soldierPop = homeProvince->getSoldierPopForArmy(true);
 		}
@@ -2158,7 +2158,7 @@ V2Province* V2Country::getProvinceForExpeditionaryArmy()
 	for (auto pitr = provinces.begin(); pitr != provinces.end(); ++pitr)
 	{
 		if ( (pitr->second->getOwner() == tag) && !pitr->second->wasColony() && !pitr->second->wasInfidelConquest()
-			&& ( pitr->second->hasCulture(primaryCulture, 0.5) ) && ( pitr->second->getPops("soldiers").size() > 0) )
+			&& ( pitr->second->hasCulture(primaryCulture, 0.5) ) && ( pitr->second->hasPopsOfType("soldiers")) )
 		{
 			candidates.push_back(pitr->second);
 		}
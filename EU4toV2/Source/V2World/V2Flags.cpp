@@ -24,6 +24,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "V2Flags.h"
 
 #include <chrono>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <random>
@@ -35,6 +36,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "../Configuration.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
+#include "ParallelFor.h"
 #include "../Mappers/CK2TitleMapper.h"
 #include "../Mappers/ColonyFlagsetMapper.h"
 #include "../Mappers/CountryMapping.h"
@@ -375,6 +377,7 @@ void V2Flags::copyFlags() const
 void V2Flags::createCustomFlags() const
 {
 	string baseFlagFolder = "flags";
+	vector<function<void()>> flagJobs;	// the flags to composite once every source file has been checked
 
 	for (auto cflag : customFlagMapping)
 	{
@@ -411,11 +414,13 @@ void V2Flags::createCustomFlags() const
 			{
 				string destFlagPath = "Output/" + Configuration::getOutputName() + "/gfx/flags/" + V2Tag + suffix;
 
-				CreateCustomFlag( 
-					FlagColorMapper::getFlagColor(get<0>(cflag.second.colours)),
-					FlagColorMapper::getFlagColor(get<1>(cflag.second.colours)),
-					FlagColorMapper::getFlagColor(get<2>(cflag.second.colours)),
-					sourceEmblemPath, sourceFlagPath, destFlagPath);
+				FlagColour c1 = FlagColorMapper::getFlagColor(get<0>(cflag.second.colours));
+				FlagColour c2 = FlagColorMapper::getFlagColor(get<1>(cflag.second.colours));
+				FlagColour c3 = FlagColorMapper::getFlagColor(get<2>(cflag.second.colours));
+				flagJobs.push_back([=]()
+				{
+					CreateCustomFlag(c1, c2, c3, sourceEmblemPath, sourceFlagPath, destFlagPath);
+				});
 			}
 			else
 			{
@@ -432,6 +437,11 @@ void V2Flags::createCustomFlags() const
 			}
 		}
 	}
+
+	Utils::parallelFor(flagJobs.size(), [&flagJobs](size_t i)
+	{
+		flagJobs[i]();
+	});
 }
 
 
@@ -439,6 +449,7 @@ void V2Flags::createColonialFlags() const
 {
 	// I really shouldn't be hardcoding this...
 	set<string> UniqueColonialFlags{ "alyeska", "newholland", "acadia", "kanata", "novascotia", "novahollandia", "vinland", "newspain" };
+	vector<function<void()>> flagJobs;	// the flags to composite or copy once every source file has been checked
 
 	//typedef map<string, shared_ptr<colonyFlag> > V2TagToColonyFlagMap; // tag, {base,overlordtag}
 	for (auto i : colonialFlagMapping)
@@ -472,7 +483,10 @@ void V2Flags::createColonialFlags() const
 				if (flagFileFound)
 				{
 					string destFlagPath = "Output/" + Configuration::getOutputName() + "/gfx/flags/" + V2Tag + suffix;
-					CreateColonialFlag(overlordFlagPath, sourceFlagPath, destFlagPath);
+					flagJobs.push_back([=]()
+					{
+						CreateColonialFlag(overlordFlagPath, sourceFlagPath, destFlagPath);
+					});
 				}
 				else
 				{
@@ -495,7 +509,10 @@ void V2Flags::createColonialFlags() const
 				if (flagFileFound)
 				{
 					string destFlagPath = "Output/" + Configuration::getOutputName() + "/gfx/flags/" + V2Tag + suffix;
-					Utils::TryCopyFile(sourceFlagPath, destFlagPath);
+					flagJobs.push_back([=]()
+					{
+						Utils::TryCopyFile(sourceFlagPath, destFlagPath);
+					});
 				}
 				else
 				{
@@ -504,4 +521,9 @@ void V2Flags::createColonialFlags() const
 			}
 		}
 	}
+
+	Utils::parallelFor(flagJobs.size(), [&flagJobs](size_t i)
+	{
+		flagJobs[i]();
+	});
 }
\ No newline at end of file
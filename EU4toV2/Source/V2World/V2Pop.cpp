@@ -58,17 +58,3 @@ void V2Pop::output(FILE* output) const
 		fprintf(output, "\t}\n");
 	}
 }
-
-
-bool V2Pop::combine(const V2Pop& rhs)
-{
-	if ((culture == rhs.culture) && (religion == rhs.religion) && (type == rhs.type))
-	{
-		size += rhs.size;
-		return true;
-	}
-	else
-	{
-		return false;
-	}
-}
@@ -40,7 +40,6 @@ class V2Pop
 		V2Pop(Object* popObj);
 
 		void output(FILE*) const;
-		bool combine(const V2Pop& rhs);
 
 		void	changeSize(int delta)					{ size += delta; }
 		void	incrementSupportedRegimentCount()	{ supportedRegiments++; }
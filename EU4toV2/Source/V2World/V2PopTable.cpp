@@ -0,0 +1,156 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#include "V2PopTable.h"
+#include <cstdint>
+#include <unordered_map>
+
+
+
+void V2PopTable::reserve(size_t numPops)
+{
+	types.reserve(numPops);
+	cultures.reserve(numPops);
+	religions.reserve(numPops);
+	sizes.reserve(numPops);
+	supportedRegiments.reserve(numPops);
+}
+
+
+int V2PopTable::addPop(const string& type, int size, const string& culture, const string& religion)
+{
+	int typeID = getID(type);
+	int cultureID = getID(culture);
+	int religionID = getID(religion);
+	return addPop(typeID, size, cultureID, religionID);
+}
+
+
+int V2PopTable::addPop(int typeID, int size, int cultureID, int religionID)
+{
+	types.push_back(typeID);
+	cultures.push_back(cultureID);
+	religions.push_back(religionID);
+	sizes.push_back(size);
+	supportedRegiments.push_back(0);
+
+	return getNumPops() - 1;
+}
+
+
+// Each pop is merged into the first pop with the same type, culture and religion. That first pop keeps its place and is only dropped
+// if it started out empty, unless it's the very first pop in the table. This matches the old pairwise merge exactly.
+void V2PopTable::combine()
+{
+	unordered_map<uint64_t, int> firstPops;	// the first pop with each type, culture and religion
+	firstPops.reserve(sizes.size());
+	vector<bool> keep(sizes.size(), false);	// whether each pop remains after combining
+
+	for (int pop = 0; pop < getNumPops(); pop++)
+	{
+		uint64_t key = (static_cast<uint64_t>(types[pop]) << 42) | (static_cast<uint64_t>(cultures[pop]) << 21) | static_cast<uint64_t>(religions[pop]);
+		auto firstPop = firstPops.insert(make_pair(key, pop));
+		if (firstPop.second)
+		{
+			keep[pop] = ((pop == 0) || (sizes[pop] >= 1));
+		}
+		else
+		{
+			sizes[firstPop.first->second] += sizes[pop];
+		}
+	}
+
+	int numKept = 0;
+	for (int pop = 0; pop < getNumPops(); pop++)
+	{
+		if (keep[pop])
+		{
+			types[numKept] = types[pop];
+			cultures[numKept] = cultures[pop];
+			religions[numKept] = religions[pop];
+			sizes[numKept] = sizes[pop];
+			supportedRegiments[numKept] = supportedRegiments[pop];
+			numKept++;
+		}
+	}
+	types.resize(numKept);
+	cultures.resize(numKept);
+	religions.resize(numKept);
+	sizes.resize(numKept);
+	supportedRegiments.resize(numKept);
+}
+
+
+void V2PopTable::output(FILE* output) const
+{
+	for (int pop = 0; pop < getNumPops(); pop++)
+	{
+		if (sizes[pop] > 0)
+		{
+			fprintf(output, "\t%s=\n", strings[types[pop]].c_str());
+			fprintf(output, "\t{\n");
+			fprintf(output, "\t\tculture = %s\n", strings[cultures[pop]].c_str());
+			fprintf(output, "\t\treligion = %s\n", strings[religions[pop]].c_str());
+			fprintf(output, "\t\tsize=%d\n", sizes[pop]);
+			fprintf(output, "\t}\n");
+		}
+		fprintf(output, "\n");
+	}
+}
+
+
+int V2PopTable::findID(const string& text) const
+{
+	for (unsigned int ID = 0; ID < strings.size(); ID++)
+	{
+		if (strings[ID] == text)
+		{
+			return ID;
+		}
+	}
+	return -1;
+}
+
+
+int V2PopTable::getTotalSize() const
+{
+	int total = 0;
+	for (auto size: sizes)
+	{
+		total += size;
+	}
+	return total;
+}
+
+
+// a province only has a handful of distinct types, cultures and religions, so a scan beats hashing
+int V2PopTable::getID(const string& text)
+{
+	int ID = findID(text);
+	if (ID == -1)
+	{
+		strings.push_back(text);
+		ID = static_cast<int>(strings.size()) - 1;
+	}
+	return ID;
+}
@@ -0,0 +1,75 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef V2POPTABLE_H_
+#define V2POPTABLE_H_
+
+
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+using namespace std;
+
+
+
+// The pops generated for a province, stored a field at a time so the whole table takes a handful of allocations.
+// Pops are referred to by their index, and their types, cultures and religions by IDs that are only meaningful within the table.
+class V2PopTable
+{
+	public:
+		void reserve(size_t numPops);
+		int addPop(const string& type, int size, const string& culture, const string& religion);
+		int addPop(int typeID, int size, int cultureID, int religionID);
+		void combine();
+		void output(FILE*) const;
+
+		int	findID(const string& text) const;
+		void	changeSize(int pop, int delta)					{ sizes[pop] += delta; }
+		void	incrementSupportedRegimentCount(int pop)	{ supportedRegiments[pop]++; }
+
+		int				getNumPops()								const { return static_cast<int>(sizes.size()); }
+		int				getTotalSize()								const;
+		int				getSize(int pop)							const { return sizes[pop]; }
+		int				getTypeID(int pop)						const { return types[pop]; }
+		int				getCultureID(int pop)					const { return cultures[pop]; }
+		int				getReligionID(int pop)					const { return religions[pop]; }
+		const string&	getType(int pop)							const { return strings[types[pop]]; }
+		const string&	getCulture(int pop)						const { return strings[cultures[pop]]; }
+		const string&	getReligion(int pop)						const { return strings[religions[pop]]; }
+		int				getSupportedRegimentCount(int pop)	const { return supportedRegiments[pop]; }
+
+	private:
+		int getID(const string& text);
+
+		vector<string>	strings;					// the types, cultures and religions used in the table, indexed by ID
+		vector<int>		types;					// the type ID of each pop
+		vector<int>		cultures;				// the culture ID of each pop
+		vector<int>		religions;				// the religion ID of each pop
+		vector<int>		sizes;					// the size of each pop
+		vector<int>		supportedRegiments;	// the number of regiments each pop supports
+};
+
+
+
+#endif // V2POPTABLE_H_
@@ -55,7 +55,6 @@ V2Province::V2Province(string _filename)
 	oldPopulation = 0;
 	demographics.clear();
 	oldPops.clear();
-	pops.clear();
 	slaveProportion = 0.0;
 	rgoType = "";
 	terrain = "";
@@ -249,14 +248,10 @@ void V2Province::outputPops(FILE* output) const
 	}
 	else
 	{
-		if (pops.size() > 0)
+		if (pops.getNumPops() > 0)
 		{
 			fprintf(output, "%d = {\n", num);
-			for (auto i : pops)
-			{
-				i->output(output);
-				fprintf(output, "\n");
-			}
+			pops.output(output);
 			fprintf(output, "}\n");
 		}
 		else if (oldPops.size() > 0)
@@ -318,7 +313,7 @@ void V2Province::outputUnits(FILE* output) const
 	}
 }
 
-void V2Province::convertFromOldProvince(const EU4Province* oldProvince)
+void V2Province::convertFromOldProvince(const EU4Province* oldProvince, vector<string>& warnings)
 {
 	srcProvince = oldProvince;
 	inHRE = oldProvince->getInHRE();
@@ -328,7 +323,7 @@ void V2Province::convertFromOldProvince(const EU4Province* oldProvince)
 	}
 	colonial = 0;
 	wasColonised = oldProvince->wasColonised();
-	originallyInfidel = oldProvince->wasInfidelConquest();
+	originallyInfidel = oldProvince->wasInfidelConquest(warnings);
 }
 
 void V2Province::determineColonial()
@@ -362,58 +357,33 @@ void V2Province::addMinorityPop(V2Pop* minorityPop)
 void V2Province::doCreatePops(double popWeightRatio, V2Country* _owner, int popConversionAlgorithm)
 {
 	// convert pops
+	pops.reserve(demographics.size() * 11 + minorityPops.size() * demographics.size());
 	for (vector<V2Demographic>::const_iterator itr = demographics.begin(); itr != demographics.end(); ++itr)
 	{
 		createPops(*itr, popWeightRatio, _owner, popConversionAlgorithm);
 	}
-	combinePops();
+	pops.combine();
 
 	// organize pops for adding minorities
-	map<string, int>					totals;
-	map<string, vector<V2Pop*>>	thePops;
-	for (auto popItr : pops)
+	map<int, int>				totals;
+	map<int, vector<int>>	thePops;
+	for (int pop = 0; pop < pops.getNumPops(); pop++)
 	{
-		string type = popItr->getType();
-
-		auto totalsItr = totals.find(type);
-		if (totalsItr == totals.end())
-		{
-			totals.insert(make_pair(type, popItr->getSize()));
-		}
-		else
-		{
-			totalsItr->second += popItr->getSize();
-		}
-
-		auto thePopsItr = thePops.find(type);
-		if (thePopsItr == thePops.end())
-		{
-			vector<V2Pop*> newVector;
-			newVector.push_back(popItr);
-			thePops.insert(make_pair(type, newVector));
-		}
-		else
-		{
-			thePopsItr->second.push_back(popItr);
-		}
+		totals[pops.getTypeID(pop)] += pops.getSize(pop);
+		thePops[pops.getTypeID(pop)].push_back(pop);
 	}
 
 	// decrease non-minority pops and create the minorities
-	vector<V2Pop*> actualMinorities;
 	for (auto minorityItr : minorityPops)
 	{
-		int totalTypePopulation;
-		auto totalsItr = totals.find(minorityItr->getType());
-		if (totalsItr != totals.end())
+		int type = pops.findID(minorityItr->getType());
+		if (type == -1)
 		{
-			totalTypePopulation = totalsItr->second;
-		}
-		else
-		{
-			totalTypePopulation = 0;
+			continue;
 		}
+		int totalTypePopulation = totals[type];
 
-		auto thePopsItr = thePops.find(minorityItr->getType());
+		auto thePopsItr = thePops.find(type);
 		if (thePopsItr != thePops.end())
 		{
 			for (auto popsItr : thePopsItr->second)
@@ -422,27 +392,21 @@ void V2Province::doCreatePops(double popWeightRatio, V2Country* _owner, int popC
 				string newReligion = minorityItr->getReligion();
 				if (newCulture == "")
 				{
-					newCulture = popsItr->getCulture();
+					newCulture = pops.getCulture(popsItr);
 				}
 				if (newReligion == "")
 				{
-					newReligion = popsItr->getReligion();
+					newReligion = pops.getReligion(popsItr);
 				}
 
-				V2Pop* newMinority = new V2Pop(minorityItr->getType(), static_cast<int>(1.0 * popsItr->getSize() / totalTypePopulation * minorityItr->getSize() + 0.5), newCulture, newReligion);
-				actualMinorities.push_back(newMinority);
-
-				popsItr->changeSize(static_cast<int>(-1.0 * popsItr->getSize() / totalTypePopulation * minorityItr->getSize()));
+				int minoritySize = static_cast<int>(1.0 * pops.getSize(popsItr) / totalTypePopulation * minorityItr->getSize() + 0.5);
+				pops.changeSize(popsItr, static_cast<int>(-1.0 * pops.getSize(popsItr) / totalTypePopulation * minorityItr->getSize()));
+				pops.addPop(minorityItr->getType(), minoritySize, newCulture, newReligion);
 			}
 		}
 	}
 
-	// add minority pops to the main pops
-	for (auto minorityItr : actualMinorities)
-	{
-		pops.push_back(minorityItr);
-	}
-	combinePops();
+	pops.combine();
 }
 
 // each "point" here represents 0.01% (1 / 10 000) population of this culture-religion pair
@@ -832,119 +796,70 @@ void V2Province::createPops(const V2Demographic& demographic, double popWeightRa
 	{
 		int size = static_cast<int>(demographic.lowerRatio * newPopulation * slaveProportion);
 		farmers -= size;
-		V2Pop* slavesPop = new V2Pop("slaves", size, demographic.slaveCulture, demographic.religion);
-		pops.push_back(slavesPop);
+		pops.addPop("slaves", size, demographic.slaveCulture, demographic.religion);
 	}
 	if (pts.soldiers > 0)
 	{
 		int size = static_cast<int>(demographic.lowerRatio * newPopulation * (pts.soldiers / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* soldiersPop = new V2Pop("soldiers", size, demographic.culture, demographic.religion);
-		pops.push_back(soldiersPop);
+		pops.addPop("soldiers", size, demographic.culture, demographic.religion);
 	}
 	if (pts.craftsmen > 0)
 	{
 		int size = static_cast<int>(demographic.lowerRatio * newPopulation * (pts.craftsmen / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* craftsmenPop = new V2Pop("craftsmen", size, demographic.culture, demographic.religion);
-		pops.push_back(craftsmenPop);
+		pops.addPop("craftsmen", size, demographic.culture, demographic.religion);
 	}
 	if (pts.artisans > 0)
 	{
 		int size = static_cast<int>(demographic.middleRatio * newPopulation * (pts.artisans / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* artisansPop = new V2Pop("artisans", size, demographic.culture, demographic.religion);
-		pops.push_back(artisansPop);
+		pops.addPop("artisans", size, demographic.culture, demographic.religion);
 	}
 	if (pts.clergymen > 0)
 	{
 		int size = static_cast<int>(demographic.middleRatio * newPopulation * (pts.clergymen / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* clergymenPop = new V2Pop("clergymen", size, demographic.culture, demographic.religion);
-		pops.push_back(clergymenPop);
+		pops.addPop("clergymen", size, demographic.culture, demographic.religion);
 	}
 	if (pts.clerks > 0)
 	{
 		int size = static_cast<int>(demographic.middleRatio * newPopulation * (pts.clerks / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* clerksPop = new V2Pop("clerks", size, demographic.culture, demographic.religion);
-		pops.push_back(clerksPop);
+		pops.addPop("clerks", size, demographic.culture, demographic.religion);
 	}
 	if (pts.bureaucrats > 0)
 	{
 		int size = static_cast<int>(demographic.middleRatio * newPopulation * (pts.bureaucrats / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* bureaucratsPop = new V2Pop("bureaucrats", size, demographic.culture, demographic.religion);
-		pops.push_back(bureaucratsPop);
+		pops.addPop("bureaucrats", size, demographic.culture, demographic.religion);
 	}
 	if (pts.officers > 0)
 	{
 		int size = static_cast<int>(demographic.middleRatio * newPopulation * (pts.officers / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* officersPop = new V2Pop("officers", size, demographic.culture, demographic.religion);
-		pops.push_back(officersPop);
+		pops.addPop("officers", size, demographic.culture, demographic.religion);
 	}
 	if (pts.capitalists > 0)
 	{
 		int size = static_cast<int>(demographic.upperRatio * newPopulation * (pts.capitalists / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* capitalistsPop = new V2Pop("capitalists", size, demographic.culture, demographic.religion);
-		pops.push_back(capitalistsPop);
+		pops.addPop("capitalists", size, demographic.culture, demographic.religion);
 	}
 	if (pts.aristocrats > 0)
 	{
 		int size = static_cast<int>(demographic.upperRatio * newPopulation * (pts.aristocrats / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* aristocratsPop = new V2Pop("aristocrats", size, demographic.culture, demographic.religion);
-		pops.push_back(aristocratsPop);
+		pops.addPop("aristocrats", size, demographic.culture, demographic.religion);
 	}
 
-	V2Pop* farmersPop = new V2Pop("farmers", farmers, demographic.culture, demographic.religion);
-	pops.push_back(farmersPop);
+	pops.addPop("farmers", farmers, demographic.culture, demographic.religion);
 
 	/*LOG(LogLevel::Info) << "Name: " << this->getSrcProvince()->getProvName() << " demographics.upperRatio: " << demographic.upperRatio
 		<< " demographics.middleRatio: " << demographic.middleRatio << " demographics.lowerRatio: " << demographic.lowerRatio
 		<< " newPopulation: " << newPopulation << " farmer: " << farmers	<< " total: " << newPopulation;*/
 }
 
-void V2Province::combinePops()
-{
-	vector<V2Pop*> trashPops;
-	for (vector<V2Pop*>::iterator lhs = pops.begin(); lhs != pops.end(); ++lhs)
-	{
-		vector<V2Pop*>::iterator rhs = lhs;
-		for (++rhs; rhs != pops.end(); ++rhs)
-		{
-			if ((*lhs)->combine(**rhs))
-			{
-				trashPops.push_back(*rhs);
-			}
-			if ((*rhs)->getSize() < 1)
-			{
-				trashPops.push_back(*rhs);
-			}
-		}
-	}
-
-	vector<V2Pop*> consolidatedPops;
-	for (vector<V2Pop*>::iterator itr = pops.begin(); itr != pops.end(); ++itr)
-	{
-		bool isTrashed = false;
-		for (vector<V2Pop*>::iterator titr = trashPops.begin(); titr != trashPops.end(); ++titr)
-		{
-			if (*itr == *titr)
-			{
-				isTrashed = true;
-			}
-		}
-		if (!isTrashed)
-		{
-			consolidatedPops.push_back(*itr);
-		}
-	}
-	pops.swap(consolidatedPops);
-}
-
 void V2Province::addFactory(V2Factory* factory)
 {
 	map<string, V2Factory*>::iterator itr = factories.find(factory->getTypeName());
@@ -979,28 +894,20 @@ void V2Province::addPopDemographic(V2Demographic d)
 
 int V2Province::getTotalPopulation() const
 {
-	int total = 0;
-	for (vector<V2Pop*>::const_iterator itr = pops.begin(); itr != pops.end(); ++itr)
-	{
-		total += (*itr)->getSize();
-	}
-	return total;
+	return pops.getTotalSize();
 }
 
-vector<V2Pop*> V2Province::getPops(string type) const
+bool V2Province::hasPopsOfType(const string& type) const
 {
-	vector<V2Pop*> retval;
-	for (vector<V2Pop*>::const_iterator itr = pops.begin(); itr != pops.end(); ++itr)
+	int typeID = pops.findID(type);
+	for (int pop = 0; pop < pops.getNumPops(); pop++)
 	{
-		if (type == "*" || (*itr)->getType() == type)
-			retval.push_back(*itr);
+		if (pops.getTypeID(pop) == typeID)
+		{
+			return true;
+		}
 	}
-	return retval;
-}
-
-static bool PopSortBySizePredicate(const V2Pop* pop1, const V2Pop* pop2)
-{
-	return (pop1->getSize() > pop2->getSize());
+	return false;
 }
 
 // V2 requires 1000 for the first regiment and 3000 thereafter
@@ -1012,17 +919,26 @@ static int getRequiredPopForRegimentCount(int count)
 }
 
 // pick a soldier pop to use for an army.  prefer larger pops to smaller ones, and grow only if necessary.
-V2Pop* V2Province::getSoldierPopForArmy(bool force)
+// returns the soldier pop's index in the province's pops, or -1 if there isn't one
+int V2Province::getSoldierPopForArmy(bool force)
 {
-	vector<V2Pop*> spops = getPops("soldiers");
+	int soldiers = pops.findID("soldiers");
+	vector<int> spops;
+	for (int pop = 0; pop < pops.getNumPops(); pop++)
+	{
+		if (pops.getTypeID(pop) == soldiers)
+		{
+			spops.push_back(pop);
+		}
+	}
 	if (spops.size() == 0)
-		return NULL; // no soldier pops
+		return -1; // no soldier pops
 
-	sort(spops.begin(), spops.end(), PopSortBySizePredicate);
+	sort(spops.begin(), spops.end(), [this](int pop1, int pop2) { return (pops.getSize(pop1) > pops.getSize(pop2)); });
 	// try largest to smallest, without growing
-	for (vector<V2Pop*>::iterator itr = spops.begin(); itr != spops.end(); ++itr)
+	for (vector<int>::iterator itr = spops.begin(); itr != spops.end(); ++itr)
 	{
-		int growBy = getRequiredPopForRegimentCount((*itr)->getSupportedRegimentCount() + 1) - (*itr)->getSize();
+		int growBy = getRequiredPopForRegimentCount(pops.getSupportedRegimentCount(*itr) + 1) - pops.getSize(*itr);
 		if (growBy <= 0)
 		{
 			if (growSoldierPop(*itr)) // won't actually grow, but necessary to increment supported regiment count
@@ -1032,7 +948,7 @@ V2Pop* V2Province::getSoldierPopForArmy(bool force)
 		}
 	}
 	// try largest to smallest, trying to grow
-	for (vector<V2Pop*>::iterator itr = spops.begin(); itr != spops.end(); ++itr)
+	for (vector<int>::iterator itr = spops.begin(); itr != spops.end(); ++itr)
 	{
 		if (growSoldierPop(*itr))
 		{
@@ -1047,29 +963,31 @@ V2Pop* V2Province::getSoldierPopForArmy(bool force)
 	}
 	else
 	{
-		return NULL;
+		return -1;
 	}
 }
 
-bool V2Province::growSoldierPop(V2Pop* pop)
+bool V2Province::growSoldierPop(int pop)
 {
-	int growBy = getRequiredPopForRegimentCount(pop->getSupportedRegimentCount() + 1) - pop->getSize();
+	int growBy = getRequiredPopForRegimentCount(pops.getSupportedRegimentCount(pop) + 1) - pops.getSize(pop);
 	if (growBy > 0)
 	{
 		// gotta grow; find a same-culture same-religion farmer/laborer to pull from
 		int provincePop = getTotalPopulation();
+		int farmers = pops.findID("farmers");
+		int labourers = pops.findID("labourers");
 		bool foundSourcePop = false;
-		for (vector<V2Pop*>::iterator isrc = pops.begin(); isrc != pops.end(); ++isrc)
+		for (int isrc = 0; isrc < pops.getNumPops(); isrc++)
 		{
-			if ((*isrc)->getType() == "farmers" || (*isrc)->getType() == "labourers")
+			if (pops.getTypeID(isrc) == farmers || pops.getTypeID(isrc) == labourers)
 			{
-				if ((*isrc)->getCulture() == pop->getCulture() && (*isrc)->getReligion() == pop->getReligion())
+				if (pops.getCultureID(isrc) == pops.getCultureID(pop) && pops.getReligionID(isrc) == pops.getReligionID(pop))
 				{
 					// don't let the farmer/labourer shrink beneath 10% of the province population
-					if ((*isrc)->getSize() - growBy > provincePop * 0.10)
+					if (pops.getSize(isrc) - growBy > provincePop * 0.10)
 					{
-						(*isrc)->changeSize(-growBy);
-						pop->changeSize(growBy);
+						pops.changeSize(isrc, -growBy);
+						pops.changeSize(pop, growBy);
 						foundSourcePop = true;
 						break;
 					}
@@ -1081,7 +999,7 @@ bool V2Province::growSoldierPop(V2Pop* pop)
 			return false;
 		}
 	}
-	pop->incrementSupportedRegimentCount();
+	pops.incrementSupportedRegimentCount(pop);
 	return true;
 }
 
@@ -1090,17 +1008,20 @@ pair<int, int> V2Province::getAvailableSoldierCapacity() const
 	int soldierCap = 0;
 	int draftCap = 0;
 	int provincePop = getTotalPopulation();
-	for (vector<V2Pop*>::const_iterator itr = pops.begin(); itr != pops.end(); ++itr)
+	int soldiers = pops.findID("soldiers");
+	int farmers = pops.findID("farmers");
+	int labourers = pops.findID("labourers");
+	for (int pop = 0; pop < pops.getNumPops(); pop++)
 	{
-		if ((*itr)->getType() == "soldiers")
+		if (pops.getTypeID(pop) == soldiers)
 		{
 			// unused capacity is the size of the pop minus the capacity already used, or 0, if it's already overdrawn
-			soldierCap += max((*itr)->getSize() - getRequiredPopForRegimentCount((*itr)->getSupportedRegimentCount()), 0);
+			soldierCap += max(pops.getSize(pop) - getRequiredPopForRegimentCount(pops.getSupportedRegimentCount(pop)), 0);
 		}
-		else if ((*itr)->getType() == "farmers" || (*itr)->getType() == "labourers")
+		else if (pops.getTypeID(pop) == farmers || pops.getTypeID(pop) == labourers)
 		{
 			// unused capacity is the size of the pop in excess of 10% of the province pop, or 0, if it's already too small
-			draftCap += max((*itr)->getSize() - int(0.10 * provincePop), 0);
+			draftCap += max(pops.getSize(pop) - int(0.10 * provincePop), 0);
 		}
 	}
 	return pair<int, int>(soldierCap, draftCap);
@@ -1142,11 +1063,12 @@ string V2Province::getRegimentName(RegimentCategory rc)
 bool V2Province::hasCulture(string culture, float percentOfPopulation) const
 {
 	int culturePops = 0;
-	for (vector<V2Pop*>::const_iterator itr = pops.begin(); itr != pops.end(); ++itr)
+	int cultureID = pops.findID(culture);
+	for (int pop = 0; pop < pops.getNumPops(); pop++)
 	{
-		if ((*itr)->getCulture() == culture)
+		if (pops.getCultureID(pop) == cultureID)
 		{
-			culturePops += (*itr)->getSize();
+			culturePops += pops.getSize(pop);
 		}
 	}
 
@@ -1158,17 +1080,17 @@ vector<string> V2Province::getCulturesOverThreshold(float percentOfPopulation) c
 	int totalPopulation = getTotalPopulation();
 
 	map<string, double> cultureAmounts;
-	for (auto pop : pops)
+	for (int pop = 0; pop < pops.getNumPops(); pop++)
 	{
-		auto cultureAmount = cultureAmounts.find(pop->getCulture());
+		auto cultureAmount = cultureAmounts.find(pops.getCulture(pop));
 		if (cultureAmount == cultureAmounts.end())
 		{
-			cultureAmounts.insert(make_pair(pop->getCulture(), 0.0f));
-			cultureAmount = cultureAmounts.find(pop->getCulture());
+			cultureAmounts.insert(make_pair(pops.getCulture(pop), 0.0f));
+			cultureAmount = cultureAmounts.find(pops.getCulture(pop));
 		}
 		if (totalPopulation > 0)
 		{
-			cultureAmount->second += 1.0 * pop->getSize() / totalPopulation;
+			cultureAmount->second += 1.0 * pops.getSize(pop) / totalPopulation;
 		}
 	}
 
@@ -29,6 +29,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "../Configuration.h"
 #include "../EU4World/EU4World.h"
 #include "../EU4World/EU4Country.h"
+#include "V2PopTable.h"
 
 class V2Pop;
 class V2Factory;
@@ -55,7 +56,7 @@ class V2Province
 		V2Province(string _filename);
 		void output() const;
 		void outputPops(FILE*) const;
-		void convertFromOldProvince(const EU4Province* oldProvince);
+		void convertFromOldProvince(const EU4Province* oldProvince, vector<string>& warnings);
 		void determineColonial();
 		void addCore(string);
 		void addOldPop(const V2Pop*);
@@ -65,8 +66,8 @@ class V2Province
 		void addPopDemographic(V2Demographic d);
 
 		int				getTotalPopulation() const;
-		vector<V2Pop*>	getPops(string type) const;
-		V2Pop*			getSoldierPopForArmy(bool force = false);
+		bool				hasPopsOfType(const string& type) const;
+		int				getSoldierPopForArmy(bool force = false);
 		pair<int, int>	getAvailableSoldierCapacity() const;
 		string			getRegimentName(RegimentCategory rc);
 		bool				hasCulture(string culture, float percentOfPopulation) const;
@@ -97,7 +98,7 @@ class V2Province
 		bool						hasNavalBase()			const { return (navalBaseLevel > 0); }
 		int						getNavalBaseLevel()	const { return navalBaseLevel; }
 		bool						hasLandConnection()	const { return landConnection; }
-		vector<V2Pop*>			getPops()				const { return pops; }
+		const V2PopTable&		getPops()				const { return pops; }
 
 	private:
 		void outputUnits(FILE*) const;
@@ -106,8 +107,7 @@ class V2Province
 		pop_points getPopPoints_1(const V2Demographic& demographic, double newPopulation, const V2Country* _owner); // EU4 1.0-1.11
 		pop_points getPopPoints_2(const V2Demographic& demographic, double newPopulation, const V2Country* _owner); // EU4 1.12 and newer
 		void createPops(const V2Demographic& demographic, double popWeightRatio, const V2Country* _owner, int popConversionAlgorithm);
-		void combinePops();
-		bool growSoldierPop(V2Pop* pop);
+		bool growSoldierPop(int pop);
 
 		const EU4Province*		srcProvince;
 
@@ -128,7 +128,7 @@ class V2Province
 		vector<V2Demographic>	demographics;
 		vector<const V2Pop*>		oldPops;
 		vector<V2Pop*>				minorityPops;
-		vector<V2Pop*>				pops;
+		V2PopTable					pops;
 		double						slaveProportion;
 		string						rgoType;
 		string						terrain;
@@ -35,6 +35,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "ParadoxParserUTF8.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
+#include "ParallelFor.h"
 #include "../Mappers/AdjacencyMapper.h"
 #include "../Mappers/ContinentMapper.h"
 #include "../Mappers/CountryMapping.h"
@@ -609,162 +610,190 @@ struct MTo1ProvinceComp
 	vector<EU4Province*> provinces;
 };
 
+// what converting a province changed outside the province itself, which is applied once every province has been converted
+struct V2World::convertedProvince
+{
+	V2Country*						owner;		// the country the province now belongs to, if it exists
+	vector<string>					warnings;	// the warnings from converting the province, in order
+	vector<pair<int, string>>	colonies;	// the states colonised through this province, and by whom
+};
+
 void V2World::convertProvinces(const EU4World& sourceWorld)
 {
 	LOG(LogLevel::Info) << "Converting provinces";
 
-	for (auto Vic2Province : provinces)
+	// each province only reads the EU4 world and changes itself, so they're converted in parallel and then added to their owners in order
+	vector<pair<int, V2Province*>> provinceList(provinces.begin(), provinces.end());
+	vector<convertedProvince> results(provinceList.size());
+	bool resetProvinces = (Configuration::getResetProvinces() == "yes");
+	Utils::parallelFor(provinceList.size(), [&](size_t i)
+	{
+		results[i] = convertProvince(provinceList[i].first, provinceList[i].second, sourceWorld, resetProvinces);
+	});
+
+	for (unsigned int i = 0; i < results.size(); i++)
 	{
-		auto EU4ProvinceNumbers = provinceMapper::getEU4ProvinceNumbers(Vic2Province.first);
-		if (EU4ProvinceNumbers.size() == 0)
+		for (auto warning: results[i].warnings)
 		{
-			LOG(LogLevel::Warning) << "No source for " << Vic2Province.second->getName() << " (province " << Vic2Province.first << ')';
-			continue;
+			LOG(LogLevel::Warning) << warning;
 		}
-		else if (EU4ProvinceNumbers[0] == 0)
+		for (auto colony: results[i].colonies)
 		{
-			continue;
+			colonies[colony.first].insert(colony.second);
 		}
-		else if ((Configuration::getResetProvinces() == "yes") && provinceMapper::isProvinceResettable(Vic2Province.first))
+		if (results[i].owner != NULL)
 		{
-			Vic2Province.second->setResettable(true);
-			continue;
+			results[i].owner->addProvince(provinceList[i].second);
 		}
+	}
+}
 
-		Vic2Province.second->clearCores();
+V2World::convertedProvince V2World::convertProvince(int Vic2ProvinceNum, V2Province* Vic2Province, const EU4World& sourceWorld, bool resetProvinces) const
+{
+	convertedProvince result;
+	result.owner = NULL;
+
+	auto EU4ProvinceNumbers = provinceMapper::getEU4ProvinceNumbers(Vic2ProvinceNum);
+	if (EU4ProvinceNumbers.size() == 0)
+	{
+		result.warnings.push_back("No source for " + Vic2Province->getName() + " (province " + to_string(Vic2ProvinceNum) + ")");
+		return result;
+	}
+	else if (EU4ProvinceNumbers[0] == 0)
+	{
+		return result;
+	}
+	else if (resetProvinces && provinceMapper::isProvinceResettable(Vic2ProvinceNum))
+	{
+		Vic2Province->setResettable(true);
+		return result;
+	}
 
-		EU4Province*	oldProvince = NULL;
-		EU4Country*		oldOwner = NULL;
-		// determine ownership by province count, or total population (if province count is tied)
-		map<string, MTo1ProvinceComp> provinceBins;
-		double newProvinceTotalBaseTax = 0;
-		for (auto EU4ProvinceNumber : EU4ProvinceNumbers)
+	Vic2Province->clearCores();
+
+	EU4Province*	oldProvince = NULL;
+	EU4Country*		oldOwner = NULL;
+	// determine ownership by province count, or total population (if province count is tied)
+	map<string, MTo1ProvinceComp> provinceBins;
+	double newProvinceTotalBaseTax = 0;
+	for (auto EU4ProvinceNumber : EU4ProvinceNumbers)
+	{
+		EU4Province* province = sourceWorld.getProvince(EU4ProvinceNumber);
+		if (!province)
 		{
-			EU4Province* province = sourceWorld.getProvince(EU4ProvinceNumber);
-			if (!province)
+			result.warnings.push_back("Old province " + to_string(EU4ProvinceNumber) + " does not exist (bad mapping?)");
+			continue;
+		}
+		EU4Country* owner = province->getOwner();
+		string tag;
+		if (owner != NULL)
+		{
+			tag = owner->getTag();
+		}
+		else
+		{
+			tag = "";
+		}
+		if (provinceBins.find(tag) == provinceBins.end())
+		{
+			provinceBins[tag] = MTo1ProvinceComp();
+		}
+		if (((Configuration::getV2Gametype() == "HOD") || (Configuration::getV2Gametype() == "HoD-NNM")) && false && (owner != NULL))
+		{
+			auto stateIndex = stateMapper::getStateIndex(Vic2ProvinceNum);
+			if (stateIndex == -1)
 			{
-				LOG(LogLevel::Warning) << "Old province " << EU4ProvinceNumber << " does not exist (bad mapping?)";
+				result.warnings.push_back("Could not find state index for province " + to_string(Vic2ProvinceNum));
 				continue;
 			}
-			EU4Country* owner = province->getOwner();
-			string tag;
-			if (owner != NULL)
-			{
-				tag = owner->getTag();
-			}
 			else
 			{
-				tag = "";
-			}
-			if (provinceBins.find(tag) == provinceBins.end())
-			{
-				provinceBins[tag] = MTo1ProvinceComp();
-			}
-			if (((Configuration::getV2Gametype() == "HOD") || (Configuration::getV2Gametype() == "HoD-NNM")) && false && (owner != NULL))
-			{
-				auto stateIndex = stateMapper::getStateIndex(Vic2Province.first);
-				if (stateIndex == -1)
-				{
-					LOG(LogLevel::Warning) << "Could not find state index for province " << Vic2Province.first;
-					continue;
-				}
-				else
-				{
-					map<int, set<string>>::iterator colony = colonies.find(stateIndex);
-					if (colony == colonies.end())
-					{
-						set<string> countries;
-						countries.insert(owner->getTag());
-						colonies.insert(make_pair(stateIndex, countries));
-					}
-					else
-					{
-						colony->second.insert(owner->getTag());
-					}
-				}
-			}
-			else
-			{
-				provinceBins[tag].provinces.push_back(province);
-				newProvinceTotalBaseTax += province->getBaseTax();
-				// I am the new owner if there is no current owner, or I have more provinces than the current owner,
-				// or I have the same number of provinces, but more population, than the current owner
-				if (
-					(oldOwner == NULL) ||
-					(provinceBins[tag].provinces.size() > provinceBins[oldOwner->getTag()].provinces.size()) ||
-					(provinceBins[tag].provinces.size() == provinceBins[oldOwner->getTag()].provinces.size())
-					)
-				{
-					oldOwner = owner;
-					oldProvince = province;
-				}
+				result.colonies.push_back(make_pair(stateIndex, owner->getTag()));
 			}
 		}
-		if (oldOwner == NULL)
+		else
 		{
-			Vic2Province.second->setOwner("");
-			continue;
+			provinceBins[tag].provinces.push_back(province);
+			newProvinceTotalBaseTax += province->getBaseTax();
+			// I am the new owner if there is no current owner, or I have more provinces than the current owner,
+			// or I have the same number of provinces, but more population, than the current owner
+			if (
+				(oldOwner == NULL) ||
+				(provinceBins[tag].provinces.size() > provinceBins[oldOwner->getTag()].provinces.size()) ||
+				(provinceBins[tag].provinces.size() == provinceBins[oldOwner->getTag()].provinces.size())
+				)
+			{
+				oldOwner = owner;
+				oldProvince = province;
+			}
 		}
+	}
+	if (oldOwner == NULL)
+	{
+		Vic2Province->setOwner("");
+		return result;
+	}
 
-		const std::string& V2Tag = CountryMapping::getVic2Tag(oldOwner->getTag());
-		if (V2Tag.empty())
+	const std::string& V2Tag = CountryMapping::getVic2Tag(oldOwner->getTag());
+	if (V2Tag.empty())
+	{
+		result.warnings.push_back("Could not map provinces owned by " + oldOwner->getTag());
+	}
+	else
+	{
+		Vic2Province->setOwner(V2Tag);
+		auto ownerItr = countries.find(V2Tag);
+		if (ownerItr != countries.end())
 		{
-			LOG(LogLevel::Warning) << "Could not map provinces owned by " << oldOwner->getTag();
+			result.owner = ownerItr->second;
 		}
-		else
-		{
-			Vic2Province.second->setOwner(V2Tag);
-			map<string, V2Country*>::iterator ownerItr = countries.find(V2Tag);
-			if (ownerItr != countries.end())
-			{
-				ownerItr->second->addProvince(Vic2Province.second);
-			}
-			Vic2Province.second->convertFromOldProvince(oldProvince);
+		Vic2Province->convertFromOldProvince(oldProvince, result.warnings);
 
-			for (map<string, MTo1ProvinceComp>::iterator mitr = provinceBins.begin(); mitr != provinceBins.end(); ++mitr)
+		for (map<string, MTo1ProvinceComp>::iterator mitr = provinceBins.begin(); mitr != provinceBins.end(); ++mitr)
+		{
+			for (vector<EU4Province*>::iterator vitr = mitr->second.provinces.begin(); vitr != mitr->second.provinces.end(); ++vitr)
 			{
-				for (vector<EU4Province*>::iterator vitr = mitr->second.provinces.begin(); vitr != mitr->second.provinces.end(); ++vitr)
+				// assign cores
+				vector<EU4Country*> oldCores = (*vitr)->getCores(sourceWorld.getCountries());
+				for (vector<EU4Country*>::iterator j = oldCores.begin(); j != oldCores.end(); j++)
 				{
-					// assign cores
-					vector<EU4Country*> oldCores = (*vitr)->getCores(sourceWorld.getCountries());
-					for (vector<EU4Country*>::iterator j = oldCores.begin(); j != oldCores.end(); j++)
+					std::string coreEU4Tag = (*j)->getTag();
+					// skip this core if the country is the owner of the EU4 province but not the V2 province
+					// (i.e. "avoid boundary conflicts that didn't exist in EU4").
+					// this country may still get core via a province that DID belong to the current V2 owner
+					if ((coreEU4Tag == mitr->first) && (coreEU4Tag != oldOwner->getTag()))
 					{
-						std::string coreEU4Tag = (*j)->getTag();
-						// skip this core if the country is the owner of the EU4 province but not the V2 province
-						// (i.e. "avoid boundary conflicts that didn't exist in EU4").
-						// this country may still get core via a province that DID belong to the current V2 owner
-						if ((coreEU4Tag == mitr->first) && (coreEU4Tag != oldOwner->getTag()))
-						{
-							continue;
-						}
-
-						const std::string& coreV2Tag = CountryMapping::getVic2Tag(coreEU4Tag);
-						if (!coreV2Tag.empty())
-						{
-							Vic2Province.second->addCore(coreV2Tag);
-						}
+						continue;
 					}
 
-					// determine demographics
-					double provPopRatio = (*vitr)->getBaseTax() / newProvinceTotalBaseTax;
-					vector<V2Demographic> demographics = determineDemographics((*vitr)->getPopRatios(), *vitr, Vic2Province.second, oldOwner, Vic2Province.first, provPopRatio);
-					for (auto demographic : demographics)
+					const std::string& coreV2Tag = CountryMapping::getVic2Tag(coreEU4Tag);
+					if (!coreV2Tag.empty())
 					{
-						Vic2Province.second->addPopDemographic(demographic);
+						Vic2Province->addCore(coreV2Tag);
 					}
+				}
 
-					// set forts and naval bases
-					if ((*vitr)->hasBuilding("fort4") || (*vitr)->hasBuilding("fort5") || (*vitr)->hasBuilding("fort6"))
-					{
-						Vic2Province.second->setFortLevel(1);
-					}
+				// determine demographics
+				double provPopRatio = (*vitr)->getBaseTax() / newProvinceTotalBaseTax;
+				vector<V2Demographic> demographics = determineDemographics((*vitr)->getPopRatios(), *vitr, Vic2Province, oldOwner, Vic2ProvinceNum, provPopRatio, result.warnings);
+				for (auto demographic : demographics)
+				{
+					Vic2Province->addPopDemographic(demographic);
+				}
+
+				// set forts and naval bases
+				if ((*vitr)->hasBuilding("fort4") || (*vitr)->hasBuilding("fort5") || (*vitr)->hasBuilding("fort6"))
+				{
+					Vic2Province->setFortLevel(1);
 				}
 			}
 		}
 	}
+
+	return result;
 }
 
-vector<V2Demographic> V2World::determineDemographics(vector<EU4PopRatio>& popRatios, EU4Province* eProv, V2Province* vProv, EU4Country* oldOwner, int destNum, double provPopRatio)
+vector<V2Demographic> V2World::determineDemographics(const vector<EU4PopRatio>& popRatios, EU4Province* eProv, V2Province* vProv, EU4Country* oldOwner, int destNum, double provPopRatio, vector<string>& warnings) const
 {
 	vector<V2Demographic> demographics;
 	for (auto prItr : popRatios)
@@ -773,13 +802,13 @@ vector<V2Demographic> V2World::determineDemographics(vector<EU4PopRatio>& popRat
 		bool matched = cultureMapper::cultureMatch(prItr.culture, dstCulture, prItr.religion, eProv->getNum(), oldOwner->getTag());
 		if (!matched)
 		{
-			LOG(LogLevel::Warning) << "Could not set culture for pops in Vic2 province " << destNum;
+			warnings.push_back("Could not set culture for pops in Vic2 province " + to_string(destNum));
 		}
 
 		string religion = religionMapper::getVic2Religion(prItr.religion);;
 		if (religion == "")
 		{
-			LOG(LogLevel::Warning) << "Could not set religion for pops in Vic2 province " << destNum;
+			warnings.push_back("Could not set religion for pops in Vic2 province " + to_string(destNum));
 		}
 
 		string slaveCulture = "";
@@ -81,8 +81,10 @@ class V2World
 		void addAllPotentialCountries();
 		void checkForCivilizedNations();
 
+		struct convertedProvince;
 		void convertProvinces(const EU4World& sourceWorld);
-		vector<V2Demographic> determineDemographics(vector<EU4PopRatio>& popRatios, EU4Province* eProv, V2Province* vProv, EU4Country* oldOwner, int destNum, double provPopRatio);
+		convertedProvince convertProvince(int Vic2ProvinceNum, V2Province* Vic2Province, const EU4World& sourceWorld, bool resetProvinces) const;
+		vector<V2Demographic> determineDemographics(const vector<EU4PopRatio>& popRatios, EU4Province* eProv, V2Province* vProv, EU4Country* oldOwner, int destNum, double provPopRatio, vector<string>& warnings) const;
 
 		void convertDiplomacy(const EU4World& sourceWorld);
 		void setupColonies();
@@ -473,6 +473,8 @@ int ConvertV2ToHoI3(const std::string& V2SaveFileName)
 
 int main(const int argc, const char * argv[])
 {
+	Log::flushOnCrash();
+
 	try
 	{
 		const char* const defaultV2SaveFileName = "input.v2";	// the default name for a save to convert
@@ -106,6 +106,14 @@ Configuration::Configuration()
 	{
 		ICStats = false;
 	}
+	if (obj[0]->getValue("SmoothFlags").size() > 0)
+	{
+		smoothFlags = true;
+	}
+	else
+	{
+		smoothFlags = false;
+	}
 
 	leaderID					= 1000;
 	leaderIDCountryIdx	= 1;
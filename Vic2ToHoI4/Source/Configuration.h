@@ -97,6 +97,11 @@ class Configuration // Singleton
 			return getInstance()->ICStats;
 		}
 
+		static bool getSmoothFlags()
+		{
+			return getInstance()->smoothFlags;
+		}
+
 		static int getNextLeaderID()
 		{
 			return getInstance()->leaderID++;
@@ -138,6 +143,7 @@ class Configuration // Singleton
 		double industrialShapeFactor;
 		double			icFactor;
 		bool ICStats;
+		bool smoothFlags;	// whether flags are scaled down by averaging rather than by picking the nearest pixels
 
 		unsigned int	leaderID;
 		unsigned int	leaderIDCountryIdx;
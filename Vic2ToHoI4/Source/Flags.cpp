@@ -23,28 +23,95 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "Flags.h"
 #include "targa.h"
+#include "BufferedOutput.h"
 #include "Log.h"
 #include "Configuration.h"
 #include "OSCompatibilityLayer.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <set>
+#include <vector>
 
 
 
-void processFlagsForCountry(const pair<string, HoI4Country*>& country);
+// A folder source flags may come from, with the names of the files in it so that finding a flag doesn't need to check the disk. The names
+// are looked up in lower case, as the disk would be on Windows.
+struct flagFolder
+{
+	string path;					// the folder, ending in a slash
+	map<string, string> flags;	// the files in the folder, by their names in lower case
+	bool allTags;					// whether flags for every tag may come from the folder, rather than only those for tags with numbers in them
+};
+
+
+vector<flagFolder> indexFlagFolders();
+void indexFlagFolder(const string& path, flagFolder& folder);
+string toLower(string name);
+void processFlagsForCountry(const pair<string, HoI4Country*>& country, const vector<flagFolder>& flagFolders);
 void copyFlags(const map<string, HoI4Country*>& countries)
 {
 	LOG(LogLevel::Info) << "Copying flags";
 
-	Utils::TryCreateFolder("Output/" + Configuration::getOutputName() + "/gfx");
-	Utils::TryCreateFolder("Output/" + Configuration::getOutputName() + "/gfx/flags");
-	Utils::TryCreateFolder("Output/" + Configuration::getOutputName() + "/gfx/flags/medium");
-	Utils::TryCreateFolder("Output/" + Configuration::getOutputName() + "/gfx/flags/small");
-	for (auto country: countries)
+	vector<string> folders = {
+		"Output/" + Configuration::getOutputName() + "/gfx/flags/medium",
+		"Output/" + Configuration::getOutputName() + "/gfx/flags/small"
+	};
+	buffered_output::createFolders(folders);
+
+	vector<flagFolder> flagFolders = indexFlagFolders();
+	vector<pair<string, HoI4Country*>> countriesToProcess(countries.begin(), countries.end());
+	Utils::parallelFor(countriesToProcess.size(), [&](size_t i)
+	{
+		processFlagsForCountry(countriesToProcess[i], flagFolders);
+	});
+}
+
+
+static set<string> allowedMods = { "PDM", "NNM", "Divergences of Darkness" };
+vector<flagFolder> indexFlagFolders()
+{
+	// the converter's own flags come first, then those in each mod in turn
+	vector<flagFolder> flagFolders;
+
+	flagFolder converterFlags;
+	converterFlags.path = "flags/";
+	converterFlags.allTags = true;
+	indexFlagFolder("flags", converterFlags);
+	flagFolders.push_back(converterFlags);
+
+	for (auto mod: Configuration::getVic2Mods())
+	{
+		flagFolder modFlags;
+		modFlags.path = Configuration::getV2Path() + "/mod/" + mod + "/gfx/flags/";
+		modFlags.allTags = (allowedMods.count(mod) > 0);
+		indexFlagFolder(Configuration::getV2Path() + "/mod/" + mod + "/gfx/flags", modFlags);
+		flagFolders.push_back(modFlags);
+	}
+
+	return flagFolders;
+}
+
+
+void indexFlagFolder(const string& path, flagFolder& folder)
+{
+	set<string> files;
+	Utils::GetAllFilesInFolder(path, files);
+	for (auto& file: files)
 	{
-		processFlagsForCountry(country);
+		folder.flags.insert(make_pair(toLower(file), file));
 	}
 }
 
 
+string toLower(string name)
+{
+	transform(name.begin(), name.end(), name.begin(), [](unsigned char c){ return static_cast<char>(tolower(c)); });
+	return name;
+}
+
+
 enum flagIdeologies
 {
 	BASE_FLAG			= 0,
@@ -85,38 +152,44 @@ char* hoi4Suffixes[FLAG_END] = {
 };
 
 
-vector<string> getSourceFlagPaths(string Vic2Tag);
+vector<string> getSourceFlagPaths(string Vic2Tag, const vector<flagFolder>& flagFolders);
 tga_image* readFlag(string path);
-tga_image* createNewFlag(const tga_image* sourceFlag, unsigned int sizeX, unsigned int sizeY);
-void createBigFlag(tga_image* sourceFlag, string filename);
-void createMediumFlag(tga_image* sourceFlag, string filename);
-void createSmallFlag(tga_image* sourceFlag, string filename);
-void processFlagsForCountry(const pair<string, HoI4Country*>& country)
+void createFlags(const tga_image* sourceFlag, string filename);
+void processFlagsForCountry(const pair<string, HoI4Country*>& country, const vector<flagFolder>& flagFolders)
 {
-	vector<string> sourcePath = getSourceFlagPaths(country.second->getSourceCountry()->getTag());
+	vector<string> sourcePath = getSourceFlagPaths(country.second->getSourceCountry()->getTag(), flagFolders);
+
+	// several ideologies often share a source flag, so each is only read once
+	map<string, tga_image*> sourceFlags;
 	for (unsigned int i = BASE_FLAG; i < FLAG_END; i++)
 	{
 		if (sourcePath[i] != "")
 		{
-			tga_image* sourceFlag = readFlag(sourcePath[i]);
-			if (sourceFlag == nullptr)
+			auto sourceFlag = sourceFlags.find(sourcePath[i]);
+			if (sourceFlag == sourceFlags.end())
 			{
-				return;
+				tga_image* newFlag = readFlag(sourcePath[i]);
+				if (newFlag == nullptr)
+				{
+					break;
+				}
+				sourceFlag = sourceFlags.insert(make_pair(sourcePath[i], newFlag)).first;
 			}
 
-			createBigFlag(sourceFlag, country.first + hoi4Suffixes[i]);
-			createMediumFlag(sourceFlag, country.first + hoi4Suffixes[i]);
-			createSmallFlag(sourceFlag, country.first + hoi4Suffixes[i]);
-
-			tga_free_buffers(sourceFlag);
-			delete sourceFlag;
+			createFlags(sourceFlag->second, country.first + hoi4Suffixes[i]);
 		}
 	}
+
+	for (auto sourceFlag: sourceFlags)
+	{
+		tga_free_buffers(sourceFlag.second);
+		delete sourceFlag.second;
+	}
 }
 
 
-string getSourceFlagPath(string Vic2Tag, string sourceSuffix);
-vector<string> getSourceFlagPaths(string Vic2Tag)
+string getSourceFlagPath(string Vic2Tag, string sourceSuffix, const vector<flagFolder>& flagFolders);
+vector<string> getSourceFlagPaths(string Vic2Tag, const vector<flagFolder>& flagFolders)
 {
 	vector<string> paths;
 	paths.resize(FLAG_END);
@@ -124,7 +197,7 @@ vector<string> getSourceFlagPaths(string Vic2Tag)
 
 	for (unsigned int i = BASE_FLAG; i < FLAG_END; i++)
 	{
-		string path = getSourceFlagPath(Vic2Tag, vic2Suffixes[i]);
+		string path = getSourceFlagPath(Vic2Tag, vic2Suffixes[i], flagFolders);
 		if (path == "")
 		{
 			LOG(LogLevel::Warning) << "Could not find source flag: " << Vic2Tag << vic2Suffixes[i];
@@ -141,47 +214,19 @@ vector<string> getSourceFlagPaths(string Vic2Tag)
 
 
 bool isThisAConvertedTag(string Vic2Tag);
-string getConversionModFlag(string flagFilename);
-string getAllowModFlags(string flagFilename);
-string getSourceFlagPath(string Vic2Tag, string sourceSuffix)
+string getSourceFlagPath(string Vic2Tag, string sourceSuffix, const vector<flagFolder>& flagFolders)
 {
-	string path = "flags/" + Vic2Tag + sourceSuffix;
-	if (!Utils::DoesFileExist(path))
+	string flagFilename = toLower(Vic2Tag + sourceSuffix);
+	bool convertedTag = isThisAConvertedTag(Vic2Tag);
+	for (auto& folder: flagFolders)
 	{
-		
-		
-			if (isThisAConvertedTag(Vic2Tag))
-			{
-				path = getConversionModFlag(Vic2Tag + sourceSuffix);
-			}
-			if (!Utils::DoesFileExist(path))
-			{
-				path = getAllowModFlags(Vic2Tag + sourceSuffix);
-			}
-			if (!Utils::DoesFileExist(path))
+		if (folder.allTags || convertedTag)
+		{
+			auto flag = folder.flags.find(flagFilename);
+			if (flag != folder.flags.end())
 			{
-				return "";
+				return folder.path + flag->second;
 			}
-		
-	}
-	return path;
-}
-
-
-bool isThisAConvertedTag(string Vic2Tag)
-{
-	return (isdigit(Vic2Tag[2]) != 0);
-}
-
-
-string getConversionModFlag(string flagFilename)
-{
-	for (auto mod: Configuration::getVic2Mods())
-	{
-		string path = Configuration::getV2Path() + "/mod/" + mod + "/gfx/flags/" + flagFilename;
-		if (Utils::DoesFileExist(path))
-		{
-			return path;
 		}
 	}
 
@@ -189,23 +234,9 @@ string getConversionModFlag(string flagFilename)
 }
 
 
-static set<string> allowedMods = { "PDM", "NNM", "Divergences of Darkness" };
-string getAllowModFlags(string flagFilename)
+bool isThisAConvertedTag(string Vic2Tag)
 {
-	for (auto mod: Configuration::getVic2Mods())
-	{
-		if (allowedMods.count(mod) == 0)
-		{
-			continue;
-		}
-		string path = Configuration::getV2Path() + "/mod/" + mod + "/gfx/flags/" + flagFilename;
-		if (Utils::DoesFileExist(path))
-		{
-			return path;
-		}
-	}
-
-	return "";
+	return (isdigit(Vic2Tag[2]) != 0);
 }
 
 
@@ -232,6 +263,37 @@ tga_image* readFlag(string path)
 }
 
 
+// Each flag is made in these sizes, each in its own folder
+struct flagSize
+{
+	unsigned int width;
+	unsigned int height;
+	const char* folder;
+};
+
+static const flagSize flagSizes[] = {
+	{ 82, 52, "/gfx/flags/" },
+	{ 41, 26, "/gfx/flags/medium/" },
+	{ 10, 7, "/gfx/flags/small/" }
+};
+
+
+tga_image* createNewFlag(const tga_image* sourceFlag, unsigned int sizeX, unsigned int sizeY);
+void writeFlag(const tga_image* flag, string filename);
+void createFlags(const tga_image* sourceFlag, string filename)
+{
+	for (auto size: flagSizes)
+	{
+		tga_image* destFlag = createNewFlag(sourceFlag, size.width, size.height);
+		writeFlag(destFlag, "Output/" + Configuration::getOutputName() + size.folder + filename);
+		tga_free_buffers(destFlag);
+		delete destFlag;
+	}
+}
+
+
+void pickNearestPixels(const tga_image* sourceFlag, tga_image* destFlag);
+void averagePixels(const tga_image* sourceFlag, tga_image* destFlag);
 tga_image* createNewFlag(const tga_image* sourceFlag, unsigned int sizeX, unsigned int sizeY)
 {
 	tga_image* destFlag = new tga_image;
@@ -251,71 +313,118 @@ tga_image* createNewFlag(const tga_image* sourceFlag, unsigned int sizeX, unsign
 	destFlag->color_map_data = nullptr;
 
 	destFlag->image_data = static_cast<uint8_t*>(malloc(sizeX * sizeY * 4));
-	for (unsigned int y = 0; y < sizeY; y++)
+	if (Configuration::getSmoothFlags())
 	{
-		for (unsigned int x = 0; x < sizeX; x++)
-		{
-			int sourceY = static_cast<int>(1.0 * y / sizeY * sourceFlag->height);
-			int sourceX = static_cast<int>(1.0 * x / sizeX * sourceFlag->width);
-			int sourceBytesPerPixel = sourceFlag->pixel_depth / 8;
-			int sourceIndex = (sourceY * sourceFlag->width + sourceX) * sourceBytesPerPixel;
-
-			int destIndex = (y * sizeX + x) * 4;
-
-			destFlag->image_data[destIndex + 0] = sourceFlag->image_data[sourceIndex + 0];
-			destFlag->image_data[destIndex + 1] = sourceFlag->image_data[sourceIndex + 1];
-			destFlag->image_data[destIndex + 2] = sourceFlag->image_data[sourceIndex + 2];
-			destFlag->image_data[destIndex + 3] = sourceFlag->image_data[sourceIndex + 3];
-		}
+		averagePixels(sourceFlag, destFlag);
+	}
+	else
+	{
+		pickNearestPixels(sourceFlag, destFlag);
 	}
 
 	return destFlag;
 }
 
 
-void createBigFlag(tga_image* sourceFlag, string filename)
+// Each destination pixel is copied from the source pixel nearest its top left corner. The source column of each destination column is
+// worked out once, leaving the inner loop as plain four byte copies.
+void pickNearestPixels(const tga_image* sourceFlag, tga_image* destFlag)
 {
-	tga_image* destFlag = createNewFlag(sourceFlag, 82, 52);
-	FILE* outputFile;
-	if (fopen_s(&outputFile, ("Output/" + Configuration::getOutputName() + "/gfx/flags/" + filename).c_str(), "w+b") != 0)
+	unsigned int sizeX = destFlag->width;
+	unsigned int sizeY = destFlag->height;
+	unsigned int sourceBytesPerPixel = sourceFlag->pixel_depth / 8;
+
+	vector<unsigned int> sourceOffsets(sizeX);	// where in a source row each destination column comes from
+	for (unsigned int x = 0; x < sizeX; x++)
 	{
-		LOG(LogLevel::Warning) << "Could not create Output/" << Configuration::getOutputName() << "/gfx/flags/" << filename;
-		return;
+		sourceOffsets[x] = static_cast<int>(1.0 * x / sizeX * sourceFlag->width) * sourceBytesPerPixel;
+	}
+
+	for (unsigned int y = 0; y < sizeY; y++)
+	{
+		int sourceY = static_cast<int>(1.0 * y / sizeY * sourceFlag->height);
+		const uint8_t* sourceRow = sourceFlag->image_data + sourceY * sourceFlag->width * sourceBytesPerPixel;
+		uint8_t* destRow = destFlag->image_data + y * sizeX * 4;
+		for (unsigned int x = 0; x < sizeX; x++)
+		{
+			memcpy(destRow + x * 4, sourceRow + sourceOffsets[x], 4);
+		}
 	}
-	tga_write_to_FILE(outputFile, destFlag);
-	fclose(outputFile);
-	tga_free_buffers(destFlag);
-	delete destFlag;
 }
 
 
-void createMediumFlag(tga_image* sourceFlag, string filename)
+// Each destination pixel is the average of the source pixels it covers. The source rows under each destination row are first summed
+// column by column, which runs straight along the rows, and then the columns under each destination pixel are summed from those.
+void averagePixels(const tga_image* sourceFlag, tga_image* destFlag)
 {
-	tga_image* destFlag = createNewFlag(sourceFlag, 41, 26);
-	FILE* outputFile;
-	if (fopen_s(&outputFile, ("Output/" + Configuration::getOutputName() + "/gfx/flags/medium/" + filename).c_str(), "w+b") != 0)
+	unsigned int sizeX = destFlag->width;
+	unsigned int sizeY = destFlag->height;
+	unsigned int sourceWidth = sourceFlag->width;
+	unsigned int sourceHeight = sourceFlag->height;
+	unsigned int sourceBytesPerPixel = sourceFlag->pixel_depth / 8;
+	unsigned int channels = min(sourceBytesPerPixel, 4u);	// 24 bit flags have no alpha, and are made opaque
+
+	vector<unsigned int> firstColumns(sizeX + 1);	// the first source column under each destination column, and the width at the end
+	for (unsigned int x = 0; x <= sizeX; x++)
 	{
-		LOG(LogLevel::Warning) << "Could not create Output/" << Configuration::getOutputName() << "/gfx/flags/medium/" << filename;
-		return;
+		firstColumns[x] = x * sourceWidth / sizeX;
+	}
+
+	vector<uint32_t> columnSums(sourceWidth * 4);	// the sum of each channel of each source column under the current destination row
+	for (unsigned int y = 0; y < sizeY; y++)
+	{
+		unsigned int firstRow = y * sourceHeight / sizeY;
+		unsigned int endRow = max((y + 1) * sourceHeight / sizeY, firstRow + 1);
+
+		fill(columnSums.begin(), columnSums.end(), 0);
+		for (unsigned int sourceY = firstRow; sourceY < endRow; sourceY++)
+		{
+			const uint8_t* sourceRow = sourceFlag->image_data + sourceY * sourceWidth * sourceBytesPerPixel;
+			for (unsigned int sourceX = 0; sourceX < sourceWidth; sourceX++)
+			{
+				for (unsigned int channel = 0; channel < channels; channel++)
+				{
+					columnSums[sourceX * 4 + channel] += sourceRow[sourceX * sourceBytesPerPixel + channel];
+				}
+			}
+		}
+
+		uint8_t* destRow = destFlag->image_data + y * sizeX * 4;
+		for (unsigned int x = 0; x < sizeX; x++)
+		{
+			unsigned int firstColumn = firstColumns[x];
+			unsigned int endColumn = max(firstColumns[x + 1], firstColumn + 1);
+			uint32_t pixelSums[4] = { 0, 0, 0, 0 };
+			for (unsigned int sourceX = firstColumn; sourceX < endColumn; sourceX++)
+			{
+				for (unsigned int channel = 0; channel < 4; channel++)
+				{
+					pixelSums[channel] += columnSums[sourceX * 4 + channel];
+				}
+			}
+
+			uint32_t numPixels = (endColumn - firstColumn) * (endRow - firstRow);
+			for (unsigned int channel = 0; channel < 4; channel++)
+			{
+				destRow[x * 4 + channel] = static_cast<uint8_t>((pixelSums[channel] + numPixels / 2) / numPixels);
+			}
+			if (channels < 4)
+			{
+				destRow[x * 4 + 3] = 0xFF;
+			}
+		}
 	}
-	tga_write_to_FILE(outputFile, destFlag);
-	fclose(outputFile);
-	tga_free_buffers(destFlag);
-	delete destFlag;
 }
 
 
-void createSmallFlag(tga_image* sourceFlag, string filename)
+void writeFlag(const tga_image* flag, string filename)
 {
-	tga_image* destFlag = createNewFlag(sourceFlag, 10, 7);
 	FILE* outputFile;
-	if (fopen_s(&outputFile, ("Output/" + Configuration::getOutputName() + "/gfx/flags/small/" + filename).c_str(), "w+b") != 0)
+	if (fopen_s(&outputFile, filename.c_str(), "w+b") != 0)
 	{
-		LOG(LogLevel::Warning) << "Could not create Output/" << Configuration::getOutputName() << "/gfx/flags/small/" << filename;
+		LOG(LogLevel::Warning) << "Could not create " << filename;
 		return;
 	}
-	tga_write_to_FILE(outputFile, destFlag);
+	tga_write_to_FILE(outputFile, flag);
 	fclose(outputFile);
-	tga_free_buffers(destFlag);
-	delete destFlag;
-}
\ No newline at end of file
+}
@@ -34,7 +34,7 @@ HoI4Airplane::HoI4Airplane(string _type, string _owner, int _amount)
 
 
 
-ofstream& operator << (ofstream& output, HoI4Airplane& instance)
+ostream& operator << (ostream& output, HoI4Airplane& instance)
 {
 	output << "\t\t" << instance.type << " = {\n";
 	output << "\t\t\towner = \"" << instance.owner << "\"\n";
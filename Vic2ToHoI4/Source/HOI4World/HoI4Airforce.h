@@ -37,7 +37,7 @@ class HoI4Airplane
 	public:
 		HoI4Airplane(string _type, string _owner, int _amount);
 
-		friend ofstream& operator << (ofstream& output, HoI4Airplane& instance);
+		friend ostream& operator << (ostream& output, HoI4Airplane& instance);
 
 	private:
 		string type;
@@ -25,6 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "../Configuration.h"
 #include "../Mappers/CoastalHoI4Provinces.h"
 #include "../Mappers/ProvinceNeighborMapper.h"
+#include "BufferedOutput.h"
 #include "log.h"
 #include "HoI4Province.h"
 #include <string>
@@ -103,7 +104,7 @@ void HoI4Buildings::placeNavalBases(const map<int, int>& provinceToStateIDMap)
 
 void HoI4Buildings::output() const
 {
-	ofstream out("output/" + Configuration::getOutputName() + "/map/buildings.txt");
+	buffered_output::file out("output/" + Configuration::getOutputName() + "/map/buildings.txt");
 	if (!out.is_open())
 	{
 		LOG(LogLevel::Error) << "Could not open output/" << Configuration::getOutputName() << "/map/buildings.txt";
@@ -0,0 +1,205 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#include "HoI4CapitalGrid.h"
+#include <algorithm>
+#include <cmath>
+#include "HoI4Country.h"
+#include "HoI4State.h"
+#include "Log.h"
+#include "../Mappers/MapTopologyCache.h"
+
+
+
+static const int mapWidth = 5250;	// distances wrap around the map at this width
+static const int cellSize = 250;	// the width and height of each cell, which divides the map width so the columns wrap cleanly
+static const int numColumns = mapWidth / cellSize;	// how many columns of cells there are
+static const double noCapitalDistance = 100000;	// the distance to or from a country with no capital
+
+
+
+static int floorDivide(int numerator, int denominator)
+{
+	return (numerator >= 0) ? (numerator / denominator) : -((denominator - 1 - numerator) / denominator);
+}
+
+
+HoI4CapitalGrid::HoI4CapitalGrid(const map<string, HoI4Country*>& countries, const map<int, HoI4State*>& states):
+	capitals(),
+	countryToCapital(),
+	cells(),
+	minY(0),
+	numRows(0)
+{
+	auto provincePositions = mapTopologyCache::getProvincePositions();
+	for (auto country: countries)
+	{
+		if (country.second->getCapitalProv() == 0)
+		{
+			continue;
+		}
+
+		auto capitalState = states.find(country.second->getCapitalProv());
+		if ((capitalState == states.end()) || capitalState->second->getProvinces().empty())
+		{
+			LOG(LogLevel::Warning) << "Could not find the capital state of " << country.first;
+			continue;
+		}
+		auto position = provincePositions.find(*capitalState->second->getProvinces().begin());
+		if (position == provincePositions.end())
+		{
+			LOG(LogLevel::Warning) << "Could not find the position of the capital of " << country.first;
+			continue;
+		}
+
+		capital newCapital = { country.second, position->second };
+		countryToCapital.insert(make_pair(country.second, capitals.size()));
+		capitals.push_back(newCapital);
+	}
+	if (capitals.empty())
+	{
+		return;
+	}
+
+	minY = capitals[0].position.second;
+	int maxY = capitals[0].position.second;
+	for (auto& capital: capitals)
+	{
+		minY = min(minY, capital.position.second);
+		maxY = max(maxY, capital.position.second);
+	}
+	numRows = (maxY - minY) / cellSize + 1;
+
+	cells.resize(numRows * numColumns);
+	for (size_t i = 0; i < capitals.size(); i++)
+	{
+		int column = floorDivide(capitals[i].position.first, cellSize) % numColumns;
+		if (column < 0)
+		{
+			column += numColumns;
+		}
+		int row = (capitals[i].position.second - minY) / cellSize;
+		cells[row * numColumns + column].push_back(i);
+	}
+}
+
+
+double HoI4CapitalGrid::getDistanceBetweenCountries(const HoI4Country* country1, const HoI4Country* country2) const
+{
+	pair<int, int> country1Position;
+	pair<int, int> country2Position;
+	if (!getCapitalPosition(country1, country1Position) || !getCapitalPosition(country2, country2Position))
+	{
+		return noCapitalDistance;
+	}
+
+	return getDistanceBetweenPoints(country1Position, country2Position);
+}
+
+
+map<string, HoI4Country*> HoI4CapitalGrid::getCountriesWithin(const HoI4Country* country, double radius) const
+{
+	map<string, HoI4Country*> countriesWithin;
+
+	pair<int, int> position;
+	if (!getCapitalPosition(country, position))
+	{
+		return countriesWithin;
+	}
+
+	vector<const capital*> found;
+	addCountriesWithin(position, radius, found);
+	for (auto capital: found)
+	{
+		countriesWithin.insert(make_pair(capital->country->getTag(), capital->country));
+	}
+
+	return countriesWithin;
+}
+
+
+double HoI4CapitalGrid::getDistanceBetweenPoints(pair<int, int> point1, pair<int, int> point2)
+{
+	int xDistance = abs(point2.first - point1.first);
+	if (xDistance > (mapWidth / 2))
+	{
+		xDistance = mapWidth - xDistance;
+	}
+
+	int yDistance = point2.second - point1.second;
+
+	return sqrt(pow(xDistance, 2) + pow(yDistance, 2));
+}
+
+
+bool HoI4CapitalGrid::getCapitalPosition(const HoI4Country* country, pair<int, int>& position) const
+{
+	auto capitalIndex = countryToCapital.find(country);
+	if (capitalIndex == countryToCapital.end())
+	{
+		return false;
+	}
+
+	position = capitals[capitalIndex->second].position;
+	return true;
+}
+
+
+// Only the cells that overlap the square around the circle need checking, wrapping around the map where the square crosses its edge
+void HoI4CapitalGrid::addCountriesWithin(pair<int, int> position, double radius, vector<const capital*>& found) const
+{
+	if (cells.empty() || (radius < 0))
+	{
+		return;
+	}
+
+	int reach = static_cast<int>(ceil(radius));
+	int firstColumn = floorDivide(position.first - reach, cellSize);
+	int lastColumn = floorDivide(position.first + reach, cellSize);
+	if ((lastColumn - firstColumn + 1) >= numColumns)
+	{
+		firstColumn = 0;
+		lastColumn = numColumns - 1;
+	}
+	int firstRow = max(0, floorDivide(position.second - reach - minY, cellSize));
+	int lastRow = min(numRows - 1, floorDivide(position.second + reach - minY, cellSize));
+
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		for (int column = firstColumn; column <= lastColumn; column++)
+		{
+			int wrappedColumn = column % numColumns;
+			if (wrappedColumn < 0)
+			{
+				wrappedColumn += numColumns;
+			}
+			for (auto index: cells[row * numColumns + wrappedColumn])
+			{
+				if (getDistanceBetweenPoints(position, capitals[index].position) <= radius)
+				{
+					found.push_back(&capitals[index]);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,76 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef HOI4_CAPITAL_GRID_H
+#define HOI4_CAPITAL_GRID_H
+
+
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+
+
+class HoI4Country;
+class HoI4State;
+
+
+
+// The position of every country's capital, bucketed into a grid of map cells so that the countries near a point can be found without
+// measuring the distance to every other country. The map wraps around from left to right, and so does the grid.
+class HoI4CapitalGrid
+{
+	public:
+		HoI4CapitalGrid(const map<string, HoI4Country*>& countries, const map<int, HoI4State*>& states);
+
+		// Countries without a capital on the map are 100000 from everything
+		double getDistanceBetweenCountries(const HoI4Country* country1, const HoI4Country* country2) const;
+
+		// Every country whose capital is no further than radius from the country's capital, including the country itself
+		map<string, HoI4Country*> getCountriesWithin(const HoI4Country* country, double radius) const;
+
+		static double getDistanceBetweenPoints(pair<int, int> point1, pair<int, int> point2);
+
+	private:
+		struct capital
+		{
+			HoI4Country* country;	// the country
+			pair<int, int> position;	// where its capital is
+		};
+
+		bool getCapitalPosition(const HoI4Country* country, pair<int, int>& position) const;
+		void addCountriesWithin(pair<int, int> position, double radius, vector<const capital*>& found) const;
+
+		vector<capital> capitals;	// every country with a capital on the map
+		unordered_map<const HoI4Country*, size_t> countryToCapital;	// where each country is in capitals
+		vector<vector<size_t>> cells;	// the capitals in each cell, by row and then column
+		int minY;	// the y of the top edge of the first row
+		int numRows;	// how many rows of cells there are
+};
+
+
+
+#endif // HOI4_CAPITAL_GRID_H
@@ -24,6 +24,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "HoI4Country.h"
 #include "HoI4World.h"
 #include <fstream>
+#include "BufferedOutput.h"
 #include "Log.h"
 #include "ParadoxParserUTF8.h"
 #include "HoI4Faction.h"
@@ -80,6 +81,7 @@ HoI4Country::HoI4Country(string _tag, string _commonCountryFile, HoI4World* _the
 	technologies.clear();
 
 	capital = 0;
+	capitalProvince = 0;
 	ideology = "despotism";
 	government = "";
 	faction = nullptr;
@@ -126,7 +128,7 @@ HoI4Country::HoI4Country(string _tag, string _commonCountryFile, HoI4World* _the
 void HoI4Country::output(const map<int, HoI4State*>& states, const vector<HoI4Faction*>& Factions) const
 {
 	// output history file
-	ofstream output;
+	buffered_output::file output;
 
 	if (((capital > 0) && (capital <= static_cast<int>(states.size())))
 		&& newCountry
@@ -135,7 +137,7 @@ void HoI4Country::output(const map<int, HoI4State*>& states, const vector<HoI4Fa
 		output.open("Output/" + Configuration::getOutputName() + "/history/countries/" + Utils::convertUTF8ToASCII(filename));
 		if (!output.is_open())
 		{
-			Log(LogLevel::Error) << "Could not open " << "Output/" << Configuration::getOutputName() << "/common/history/" << Utils::convertUTF8ToASCII(filename);
+			LOG(LogLevel::Error) << "Could not open " << "Output/" << Configuration::getOutputName() << "/common/history/" << Utils::convertUTF8ToASCII(filename);
 			exit(-1);
 		}
 		output << "\xEF\xBB\xBF";    // add the BOM to make HoI4 happy
@@ -396,11 +398,11 @@ void HoI4Country::output(const map<int, HoI4State*>& states, const vector<HoI4Fa
 
 void HoI4Country::outputCommonCountryFile() const
 {
-	ofstream output;
+	buffered_output::file output;
 	output.open("Output/" + Configuration::getOutputName() + "/common/countries/" + Utils::convertUTF8ToASCII(commonCountryFile));
 	if (!output.is_open())
 	{
-		Log(LogLevel::Error) << "Could not open " << "Output/" << Configuration::getOutputName() << "/common/countries/" << Utils::convertUTF8ToASCII(commonCountryFile);
+		LOG(LogLevel::Error) << "Could not open " << "Output/" << Configuration::getOutputName() << "/common/countries/" << Utils::convertUTF8ToASCII(commonCountryFile);
 		exit(-1);
 	}
 
@@ -414,7 +416,7 @@ void HoI4Country::outputCommonCountryFile() const
 }
 
 
-void HoI4Country::outputColors(ofstream& out) const
+void HoI4Country::outputColors(ostream& out) const
 {
 	int red;
 	int green;
@@ -428,9 +430,9 @@ void HoI4Country::outputColors(ofstream& out) const
 }
 
 
-void HoI4Country::outputToCommonCountriesFile(FILE* output) const
+void HoI4Country::outputToCommonCountriesFile(ostream& output) const
 {
-	fprintf(output, "%s = \"countries%s\"\n", tag.c_str(), Utils::convertUTF8ToASCII(commonCountryFile).c_str());
+	output << tag << " = \"countries" << Utils::convertUTF8ToASCII(commonCountryFile) << "\"\n";
 }
 
 
@@ -526,7 +528,7 @@ void HoI4Country::outputLeaders() const
 }
 
 
-void HoI4Country::outputRelations(ofstream& output) const
+void HoI4Country::outputRelations(ostream& output) const
 {
 	for (auto relation: relations)
 	{
@@ -540,10 +542,10 @@ void HoI4Country::outputRelations(ofstream& output) const
 
 void HoI4Country::outputOOB() const
 {
-	ofstream output("Output/" + Configuration::getOutputName() + "/history/units/" + tag + "_OOB.txt");
+	buffered_output::file output("Output/" + Configuration::getOutputName() + "/history/units/" + tag + "_OOB.txt");
 	if (!output.is_open())
 	{
-		Log(LogLevel::Error) << "Could not open Output/" << Configuration::getOutputName() << "/history/units/" << tag << "_OOB.txt";
+		LOG(LogLevel::Error) << "Could not open Output/" << Configuration::getOutputName() << "/history/units/" << tag << "_OOB.txt";
 		exit(-1);
 	}
 	output << "\xEF\xBB\xBF";	// add the BOM to make HoI4 happy
@@ -609,7 +611,9 @@ void HoI4Country::outputOOB() const
 }
 
 
-void HoI4Country::initFromV2Country(const V2World& _srcWorld, const V2Country* _srcCountry, const string _vic2ideology, map<int, int>& leaderMap, governmentJobsMap governmentJobs, const namesMapping& namesMap, portraitMapping& portraitMap, const cultureMapping& cultureMap, personalityMap& landPersonalityMap, personalityMap& seaPersonalityMap, backgroundMap& landBackgroundMap, backgroundMap& seaBackgroundMap, const map<int, int>& stateMap, map<int, HoI4State*> states)
+// Only reads state shared with other countries, so countries can be initialized in parallel. Leaders, ministers and the capital state are
+// set up afterwards by initLeadersFromV2Country() and setCapitalInCapitalState().
+void HoI4Country::initFromV2Country(const V2World& _srcWorld, const V2Country* _srcCountry, const string _vic2ideology, const cultureMapping& cultureMap, const map<int, int>& stateMap, const map<int, HoI4State*>& states)
 {
 	srcCountry = _srcCountry;
 	filename = Utils::GetFileFromTag("./blankMod/output/history/countries/", tag);
@@ -668,34 +672,6 @@ void HoI4Country::initFromV2Country(const V2World& _srcWorld, const V2Country* _
 		}
 	}
 
-	// Ministers
-	vector<string> firstNames;
-	vector<string> lastNames;
-	auto namesItr = namesMap.find(srcCountry->getPrimaryCulture());
-	if (namesItr != namesMap.end())
-	{
-		firstNames = namesItr->second.first;
-		lastNames = namesItr->second.second;
-	}
-	else
-	{
-		firstNames.push_back("nul");
-		lastNames.push_back("nul");
-	}
-	for (unsigned int ideologyIdx = 0; ideologyIdx <= stalinist; ideologyIdx++)
-	{
-		for (auto job : governmentJobs)
-		{
-			HoI4Minister newMinister(firstNames, lastNames, ideologyNames[ideologyIdx], job, governmentJobs, portraitMap[graphicalCulture]);
-			ministers.push_back(newMinister);
-
-			if (ideologyNames[ideologyIdx] == ideology)
-			{
-				rulingMinisters.push_back(newMinister);
-			}
-		}
-	}
-
 	// Faction is handled in HoI4World::configureFactions
 
 	nationalUnity = 70.0 + (_srcCountry->getRevanchism() / 0.05) - (_srcCountry->getWarExhaustion() / 2.5);
@@ -788,16 +764,6 @@ void HoI4Country::initFromV2Country(const V2World& _srcWorld, const V2Country* _
 		training_laws = "minimal_training";
 	}
 
-	// leaders
-	vector<V2Leader*> srcLeaders = srcCountry->getLeaders();
-	for (auto srcLeader : srcLeaders)
-	{
-		HoI4Leader newLeader(srcLeader, tag, landPersonalityMap, seaPersonalityMap, landBackgroundMap, seaBackgroundMap, portraitMap[graphicalCulture]);
-		leaders.push_back(newLeader);
-	}
-
-	Configuration::setLeaderIDForNextCountry();
-
 	// Relations
 	map<string, V2Relations*> srcRelations = srcCountry->getRelations();
 	if (srcRelations.size() > 0)
@@ -814,17 +780,55 @@ void HoI4Country::initFromV2Country(const V2World& _srcWorld, const V2Country* _
 	}
 
 	determineCapitalFromVic2(stateMap, states);
-	auto state = states.find(capital)->second;
-	if (isThisStateOwnedByUs(state))
-	{
-		state->setAsCapitalState();
-	}
 
 	// major nation
 	majorNation = srcCountry->isGreatNation();
 }
 
 
+// Draws on the leader IDs and random numbers shared by all countries, so must be called for each country in turn
+void HoI4Country::initLeadersFromV2Country(const governmentJobsMap& governmentJobs, const namesMapping& namesMap, portraitMapping& portraitMap, personalityMap& landPersonalityMap, personalityMap& seaPersonalityMap, backgroundMap& landBackgroundMap, backgroundMap& seaBackgroundMap)
+{
+	// Ministers
+	vector<string> firstNames;
+	vector<string> lastNames;
+	auto namesItr = namesMap.find(srcCountry->getPrimaryCulture());
+	if (namesItr != namesMap.end())
+	{
+		firstNames = namesItr->second.first;
+		lastNames = namesItr->second.second;
+	}
+	else
+	{
+		firstNames.push_back("nul");
+		lastNames.push_back("nul");
+	}
+	for (unsigned int ideologyIdx = 0; ideologyIdx <= stalinist; ideologyIdx++)
+	{
+		for (auto job : governmentJobs)
+		{
+			HoI4Minister newMinister(firstNames, lastNames, ideologyNames[ideologyIdx], job, governmentJobs, portraitMap[graphicalCulture]);
+			ministers.push_back(newMinister);
+
+			if (ideologyNames[ideologyIdx] == ideology)
+			{
+				rulingMinisters.push_back(newMinister);
+			}
+		}
+	}
+
+	// leaders
+	vector<V2Leader*> srcLeaders = srcCountry->getLeaders();
+	for (auto srcLeader : srcLeaders)
+	{
+		HoI4Leader newLeader(srcLeader, tag, landPersonalityMap, seaPersonalityMap, landBackgroundMap, seaBackgroundMap, portraitMap[graphicalCulture]);
+		leaders.push_back(newLeader);
+	}
+
+	Configuration::setLeaderIDForNextCountry();
+}
+
+
 void HoI4Country::determineCapitalFromVic2(const map<int, int>& provinceToStateIDMap, const map<int, HoI4State*>& states)
 {
 	int oldCapital = srcCountry->getCapital();
@@ -835,7 +839,7 @@ void HoI4Country::determineCapitalFromVic2(const map<int, int>& provinceToStateI
 		if (capitalState != provinceToStateIDMap.end() && isStateValidForCapital(capitalState, states))
 		{
 			capital = capitalState->second;
-			setCapitalInCapitalState(itr->second[0], states);
+			capitalProvince = itr->second[0];
 		}
 		else
 		{
@@ -872,13 +876,20 @@ bool HoI4Country::isThisStateACoreWhileWeOwnNoStates(const HoI4State* state) con
 }
 
 
-void HoI4Country::setCapitalInCapitalState(int capitalProvince, const map<int, HoI4State*>& states)
+// Writes to states other countries may also claim, so must be called for each country in turn
+void HoI4Country::setCapitalInCapitalState(const map<int, HoI4State*>& states)
 {
 	auto capitalState = states.find(capital);
-	if (capitalState != states.end())
+	if ((capitalProvince != 0) && (capitalState != states.end()))
 	{
 		capitalState->second->setVPLocation(capitalProvince);
 	}
+
+	auto state = states.find(capital)->second;
+	if (isThisStateOwnedByUs(state))
+	{
+		state->setAsCapitalState();
+	}
 }
 
 
@@ -944,7 +955,7 @@ void HoI4Country::initFromHistory()
 }
 
 
-void HoI4Country::generateLeaders(leaderTraitsMap leaderTraits, const namesMapping& namesMap, portraitMapping& portraitMap)
+void HoI4Country::generateLeaders(const leaderTraitsMap& leaderTraits, const namesMapping& namesMap, portraitMapping& portraitMap)
 {
 	vector<string> firstNames;
 	vector<string> lastNames;
@@ -1044,7 +1055,7 @@ void HoI4Country::generateLeaders(leaderTraitsMap leaderTraits, const namesMappi
 }
 
 
-void HoI4Country::convertNavy(map<int, HoI4State*> states)
+void HoI4Country::convertNavy(const map<int, HoI4State*>& states)
 {
 	int navalport = 0;
 
@@ -1686,7 +1697,7 @@ HoI4Relations* HoI4Country::getRelations(string withWhom) const
 	}
 }
 
-vector<int> HoI4Country::getPortProvinces(vector<int> locationCandidates, map<int, HoI4Province*> allProvinces)
+vector<int> HoI4Country::getPortProvinces(vector<int> locationCandidates, const map<int, HoI4Province*>& allProvinces)
 {
 	// hack for naval bases.  not ALL naval bases are in port provinces, and if you spawn a navy at a naval base in
 	// a non-port province, Vicky crashes....
@@ -1730,7 +1741,7 @@ vector<int> HoI4Country::getPortProvinces(vector<int> locationCandidates, map<in
 }
 
 
-void HoI4Country::convertParties(const V2Country* srcCountry, vector<V2Party*> V2Parties, V2Party* rulingParty, string& rulingIdeology)
+void HoI4Country::convertParties(const V2Country* srcCountry, const vector<V2Party*>& V2Parties, V2Party* rulingParty, string& rulingIdeology)
 {
 	// sort Vic2 parties by ideology
 	map<string, vector<V2Party*>> V2Ideologies;
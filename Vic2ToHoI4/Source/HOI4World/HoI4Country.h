@@ -70,13 +70,15 @@ class HoI4Country
 		HoI4Country(string _tag, string _commonCountryFile, HoI4World* _theWorld, bool _newCountry = false);
 		void		output(const map<int, HoI4State*>& states, const vector<HoI4Faction*>& Factions) const;
 		void		outputCommonCountryFile() const;
-		void		outputColors(ofstream& out) const;
-		void		outputToCommonCountriesFile(FILE*) const;
+		void		outputColors(ostream& out) const;
+		void		outputToCommonCountriesFile(ostream& output) const;
 
-		void		initFromV2Country(const V2World& _srcWorld, const V2Country* _srcCountry, const string _vic2ideology, map<int, int>& leaderMap, governmentJobsMap governmentJobs, const namesMapping& namesMap, portraitMapping& portraitMap, const cultureMapping& cultureMap, personalityMap& landPersonalityMap, personalityMap& seaPersonalityMap, backgroundMap& landBackgroundMap, backgroundMap& seaBackgroundMap, const map<int, int>& stateMap, map<int, HoI4State*> states);
+		void		initFromV2Country(const V2World& _srcWorld, const V2Country* _srcCountry, const string _vic2ideology, const cultureMapping& cultureMap, const map<int, int>& stateMap, const map<int, HoI4State*>& states);
+		void		initLeadersFromV2Country(const governmentJobsMap& governmentJobs, const namesMapping& namesMap, portraitMapping& portraitMap, personalityMap& landPersonalityMap, personalityMap& seaPersonalityMap, backgroundMap& landBackgroundMap, backgroundMap& seaBackgroundMap);
+		void		setCapitalInCapitalState(const map<int, HoI4State*>& states);
 		void		initFromHistory();
-		void		generateLeaders(leaderTraitsMap leaderTraits, const namesMapping& namesMap, portraitMapping& portraitMap);
-		void		convertNavy(map<int, HoI4State*> states);
+		void		generateLeaders(const leaderTraitsMap& leaderTraits, const namesMapping& namesMap, portraitMapping& portraitMap);
+		void		convertNavy(const map<int, HoI4State*>& states);
 		void		convertAirforce();
 		void		convertArmyDivisions();
 		void		setTechnology(string tech, int level);
@@ -99,7 +101,7 @@ class HoI4Country
 		double getEconomicStrength(double years) const;
 		
 		const map<string, HoI4Relations*>&	getRelations() const			{ return relations; }
-		set<int>									getProvinces() const			{ return provinces; }
+		const set<int>&							getProvinces() const			{ return provinces; }
 		string										getTag() const					{ return tag; }
 		const V2Country*							getSourceCountry() const	{ return srcCountry; }
 		string										getGovernment() const		{ return government; }
@@ -112,14 +114,14 @@ class HoI4Country
 		set<string>&								editAllies()					{ return allies; }
 		map<string, double>&						getPracticals()				{ return practicals; }
 		int											getCapitalNum()				{ return capital; }
-		vector<int>									getBrigs() const			{ return brigs; }
+		const vector<int>&						getBrigs() const			{ return brigs; }
 		int											getCapitalProv() const { return capital; }
 		const string									getSphereLeader() const { return sphereLeader; }
-		HoI4Party									getRulingParty() const { return RulingPartyModel; }
-		map<int, HoI4State*> getStates() const { return states; }
+		const HoI4Party&							getRulingParty() const { return RulingPartyModel; }
+		const map<int, HoI4State*>& getStates() const { return states; }
 		bool isInFaction() const { return faction != nullptr; }
 		
-		vector<HoI4Party> getParties() const { return parties; }
+		const vector<HoI4Party>& getParties() const { return parties; }
 		int getTotalFactories() const { return totalfactories; }
 		int getTechnologyCount() const { return technologies.size(); }
 		int getProvinceCount() const { return provinceCount; }
@@ -132,17 +134,16 @@ class HoI4Country
 		void			outputTech(FILE*)				const;
 		void			outputParties(FILE*)			const;
 		void			outputLeaders()				const;
-		void outputRelations(ofstream& output) const;
+		void outputRelations(ostream& output) const;
 
 		void determineCapitalFromVic2(const map<int, int>& provinceToStateIDMap, const map<int, HoI4State*>& states);
 		bool isStateValidForCapital(map<int, int>::const_iterator capitalState, const map<int, HoI4State*>& states);
 		bool isThisStateOwnedByUs(const HoI4State* state) const;
 		bool isThisStateACoreWhileWeOwnNoStates(const HoI4State* state) const;
-		void setCapitalInCapitalState(int capitalProvince, const map<int, HoI4State*>& states);
 		void findBestCapital();
 
-		vector<int>	getPortProvinces(vector<int> locationCandidates, map<int, HoI4Province*> allProvinces);
-		void			convertParties(const V2Country* srcCountry, vector<V2Party*> V2Parties, V2Party* rulingParty, string& rulingIdeology);
+		vector<int>	getPortProvinces(vector<int> locationCandidates, const map<int, HoI4Province*>& allProvinces);
+		void			convertParties(const V2Country* srcCountry, const vector<V2Party*>& V2Parties, V2Party* rulingParty, string& rulingIdeology);
 
 		void setPartyPopularity();
 		
@@ -156,6 +157,7 @@ class HoI4Country
 		set<int>							provinces;
 		map<int, HoI4State*> states;
 		int									capital;
+		int									capitalProvince;	// the province to put the capital VP in, or 0 if the capital state keeps its own
 		string								commonCountryFile;
 		map<string, int>					technologies;
 		string								government;
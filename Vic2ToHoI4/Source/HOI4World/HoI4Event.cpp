@@ -25,7 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
-ofstream& operator << (ofstream& out, HoI4Event theEvent)
+ostream& operator << (ostream& out, HoI4Event theEvent)
 {
 	out << theEvent.type << " = {\n";
 	out << "	id = " << theEvent.id << "\n";
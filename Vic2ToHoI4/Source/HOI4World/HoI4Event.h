@@ -36,7 +36,7 @@ using namespace std;
 class HoI4Event
 {
 	public:
-		friend ofstream& operator << (ofstream& out, HoI4Event theEvent);
+		friend ostream& operator << (ostream& out, HoI4Event theEvent);
 
 		string type;
 		string id;
@@ -25,6 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <fstream>
 #include "HoI4Country.h"
 #include "HoI4Faction.h"
+#include "BufferedOutput.h"
 #include "Log.h"
 
 
@@ -45,7 +46,7 @@ void HoI4Events::output() const
 
 void HoI4Events::outputNationalFocusEvents() const
 {
-	ofstream outEvents("Output/" + Configuration::getOutputName() + "/events/NF_events.txt");
+	buffered_output::file outEvents("Output/" + Configuration::getOutputName() + "/events/NF_events.txt");
 	if (!outEvents.is_open())
 	{
 		LOG(LogLevel::Error) << "Could not create NF_events.txt";
@@ -66,7 +67,7 @@ void HoI4Events::outputNationalFocusEvents() const
 
 void HoI4Events::outputNewsEvents() const
 {
-	ofstream outNewsEvents("Output/" + Configuration::getOutputName() + "/events/newsEvents.txt");
+	buffered_output::file outNewsEvents("Output/" + Configuration::getOutputName() + "/events/newsEvents.txt");
 	if (!outNewsEvents.is_open())
 	{
 		LOG(LogLevel::Error) << "Could not create newsEvents.txt";
@@ -74,11 +75,11 @@ void HoI4Events::outputNewsEvents() const
 	}
 
 	outNewsEvents << "\xEF\xBB\xBF";
-	outNewsEvents << "add_namespace = news\n" << flush;
+	outNewsEvents << "add_namespace = news\n";
 	for (auto theEvent: newsEvents)
 	{
-		outNewsEvents << "\n" << flush;
-		outNewsEvents << theEvent << flush;
+		outNewsEvents << "\n";
+		outNewsEvents << theEvent;
 	}
 
 	outNewsEvents.close();
@@ -25,6 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "HoI4Country.h"
 #include "HoI4Focus.h"
 #include "../Configuration.h"
+#include "BufferedOutput.h"
 #include "Log.h"
 #include "Object.h"
 #include "ParadoxParserUTF8.h"
@@ -3450,7 +3451,7 @@ HoI4FocusTree* HoI4FocusTree::makeCustomizedCopy(const HoI4Country* country) con
 }
 
 
-void HoI4FocusTree::addDemocracyNationalFocuses(HoI4Country* Home, vector<HoI4Country*> CountriesToContain, int XStart)
+void HoI4FocusTree::addDemocracyNationalFocuses(HoI4Country* Home, const vector<HoI4Country*>& CountriesToContain, int XStart)
 {
 	double WTModifier = 1;
 	if (Home->getGovernment() == "democratic")
@@ -4323,7 +4324,7 @@ void HoI4FocusTree::addMonarchyEmpireNationalFocuses(HoI4Country* Home, const ve
 void HoI4FocusTree::output()
 {
 	string filename("Output/" + Configuration::getOutputName() + "/common/national_focus/" + srcCountryTag + "_NF.txt");
-	ofstream out(filename);
+	buffered_output::file out(filename);
 	if (!out.is_open())
 	{
 		LOG(LogLevel::Error) << "Could not create " << filename;
@@ -46,7 +46,7 @@ class HoI4FocusTree
 		HoI4FocusTree* makeCustomizedCopy(const HoI4Country* country) const;
 
 		void addGenericFocusTree();
-		void addDemocracyNationalFocuses(HoI4Country* Home, vector<HoI4Country*> CountriesToContain, int XStart);
+		void addDemocracyNationalFocuses(HoI4Country* Home, const vector<HoI4Country*>& CountriesToContain, int XStart);
 		void addMonarchyEmpireNationalFocuses(HoI4Country* country, const vector<HoI4Country*>& targetColonies, const vector<HoI4Country*>& annexationTargets);
 
 		void output();
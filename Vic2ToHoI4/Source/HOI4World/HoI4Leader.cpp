@@ -25,7 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
-HoI4Leader::HoI4Leader(vector<string>& firstNames, vector<string>& lastNames, string _country, string _type, leaderTraitsMap& _traitsMap, vector<string>& portraits)
+HoI4Leader::HoI4Leader(vector<string>& firstNames, vector<string>& lastNames, string _country, string _type, const leaderTraitsMap& _traitsMap, vector<string>& portraits)
 {
 	ID			= Configuration::getNextLeaderID();
 	name		= firstNames[rand() % firstNames.size()] + " " + lastNames[rand() % lastNames.size()];
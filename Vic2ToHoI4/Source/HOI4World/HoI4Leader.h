@@ -36,7 +36,7 @@ using namespace std;
 class HoI4Leader
 {
 	public:
-		HoI4Leader(vector<string>& firstNames, vector<string>& lastNames, string _country, string _type, leaderTraitsMap& _traitsMap, vector<string>& portraits);
+		HoI4Leader(vector<string>& firstNames, vector<string>& lastNames, string _country, string _type, const leaderTraitsMap& _traitsMap, vector<string>& portraits);
 		HoI4Leader(V2Leader* srcLeader, string _country, personalityMap& landPersonalityMap, personalityMap& seaPersonalityMap, backgroundMap& landBackgroundMap, backgroundMap& seaBackgroundMap, vector<string>& portraits);
 		void output(FILE* output);
 
@@ -24,6 +24,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "HoI4Localisation.h"
 #include <fstream>
 #include "../V2World/V2Country.h"
+#include "BufferedOutput.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
 
@@ -108,7 +109,7 @@ void HoI4Localisation::outputCountries(string localisationPath) const
 			continue;
 		}
 		string dest = localisationPath + "/countries_mod_l_" + languageToLocalisations.first + ".yml";
-		ofstream localisationFile(localisationPath + "/countries_mod_l_" + languageToLocalisations.first + ".yml");
+		buffered_output::file localisationFile(localisationPath + "/countries_mod_l_" + languageToLocalisations.first + ".yml");
 		if (!localisationFile.is_open())
 		{
 			LOG(LogLevel::Error) << "Could not update localisation text file";
@@ -25,7 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
-HoI4Minister::HoI4Minister(vector<string>& firstNames, vector<string>& lastNames, string _ideology, governmentJob job, governmentJobsMap& jobMap, vector<string>& portraits)
+HoI4Minister::HoI4Minister(vector<string>& firstNames, vector<string>& lastNames, string _ideology, governmentJob job, const governmentJobsMap& jobMap, vector<string>& portraits)
 {
 	ID			= Configuration::getNextLeaderID();
 	name		= firstNames[rand() % firstNames.size()] + " " + lastNames[rand() % lastNames.size()];
@@ -37,7 +37,7 @@ HoI4Minister::HoI4Minister(vector<string>& firstNames, vector<string>& lastNames
 	vector<string> traits = jobMap.find(job.first)->second;
 	roles.push_back(make_pair(job.first, traits[rand() % traits.size()]));
 
-	governmentJobsMap::iterator secondJob = jobMap.begin();
+	governmentJobsMap::const_iterator secondJob = jobMap.begin();
 	std::advance(secondJob, rand() % jobMap.size());
 	while (job.first == secondJob->first)
 	{
@@ -35,7 +35,7 @@ using namespace std;
 class HoI4Minister
 {
 	public:
-		HoI4Minister(vector<string>& firstNames, vector<string>& lastNames, string _ideology, governmentJob job, governmentJobsMap& jobMap, vector<string>& portraits);
+		HoI4Minister(vector<string>& firstNames, vector<string>& lastNames, string _ideology, governmentJob job, const governmentJobsMap& jobMap, vector<string>& portraits);
 		void output(FILE* output);
 
 		string			getFirstJob()	const { return roles[0].first; }
@@ -33,7 +33,7 @@ HoI4Ship::HoI4Ship(string _name, string _type, string _owner)
 }
 
 
-ofstream& operator << (ofstream& output, HoI4Ship& instance)
+ostream& operator << (ostream& output, HoI4Ship& instance)
 {
 	output << "\t\tship = {" << endl;
 	output << "\t\t\tname = \"" << instance.name << "\"" << endl;
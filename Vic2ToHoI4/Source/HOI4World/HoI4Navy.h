@@ -37,7 +37,7 @@ class HoI4Ship
 	public:
 		HoI4Ship(string _name, string _type, string _owner);
 
-		friend ofstream& operator << (ofstream& output, HoI4Ship& instance);
+		friend ostream& operator << (ostream& output, HoI4Ship& instance);
 
 	private:
 		string	name;
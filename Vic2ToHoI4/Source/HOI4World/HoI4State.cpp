@@ -31,6 +31,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "../Mappers/V2Localisations.h"
 #include "../V2World/V2Province.h"
 #include "../V2World/V2World.h"
+#include "BufferedOutput.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
 
@@ -68,7 +69,7 @@ void HoI4State::output(string _filename)
 {
 	// create the file
 	string filename("Output/" + Configuration::getOutputName() + "/history/states/" + _filename);
-	ofstream out(filename);
+	buffered_output::file out(filename);
 	if (!out.is_open())
 	{
 		LOG(LogLevel::Error) << "Could not open \"output/" + Configuration::getOutputName() + "/history/states/" + _filename;
@@ -54,9 +54,9 @@ class HoI4State
 		void addCores(const vector<string>& newCores);
 
 		const Vic2State* getSourceState() const { return sourceState; }
-		set<int>	getProvinces() const { return provinces; }
+		const set<int>&	getProvinces() const { return provinces; }
 		string getOwner() const { return ownerTag; }
-		set<string> getCores() const { return cores; }
+		const set<string>& getCores() const { return cores; }
 		int getID() const { return ID; }
 		int getDockyards() const { return dockyards; }
 		int getCivFactories() const { return civFactories; }
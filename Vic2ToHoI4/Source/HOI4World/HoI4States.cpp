@@ -22,6 +22,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 #include "HoI4States.h"
+#include "BufferedOutput.h"
 #include "log.h"
 #include "OSCompatibilityLayer.h"
 #include "ParadoxParserUTF8.h"
@@ -431,12 +432,6 @@ void HoI4States::output() const
 
 void HoI4States::outputHistory() const
 {
-	string statesPath = "Output/" + Configuration::getOutputName() + "/history/states";
-	if (!Utils::TryCreateFolder(statesPath))
-	{
-		LOG(LogLevel::Error) << "Could not create \"Output/" + Configuration::getOutputName() + "/history/states";
-		exit(-1);
-	}
 	for (auto state: states)
 	{
 		string filename;
@@ -453,7 +448,7 @@ void HoI4States::outputHistory() const
 	}
 	for (auto nameItr = stateFilenames.find(states.size() + 1); nameItr != stateFilenames.end(); nameItr++)
 	{
-		ofstream emptyStateFile("Output/" + Configuration::getOutputName() + "/history/states/" + nameItr->second);
+		buffered_output::file emptyStateFile("Output/" + Configuration::getOutputName() + "/history/states/" + nameItr->second);
 		if (!emptyStateFile.is_open())
 		{
 			LOG(LogLevel::Warning) << "Could not create " << "Output/" << Configuration::getOutputName() << "/history/states/" << nameItr->second;
@@ -471,7 +466,7 @@ void HoI4States::outputStateLocalisations() const
 		{
 			continue;
 		}
-		ofstream localisationFile("Output/" + Configuration::getOutputName() + "/localisation/state_names_l_" + languageToLocalisations.first + ".yml");
+		buffered_output::file localisationFile("Output/" + Configuration::getOutputName() + "/localisation/state_names_l_" + languageToLocalisations.first + ".yml");
 		if (!localisationFile.is_open())
 		{
 			LOG(LogLevel::Error) << "Could not update localisation text file";
@@ -496,7 +491,7 @@ void HoI4States::outputVPLocalisations() const
 		{
 			continue;
 		}
-		ofstream localisationFile("Output/" + Configuration::getOutputName() + "/localisation/victory_points_l_" + languageToLocalisations.first + ".yml");
+		buffered_output::file localisationFile("Output/" + Configuration::getOutputName() + "/localisation/victory_points_l_" + languageToLocalisations.first + ".yml");
 		if (!localisationFile.is_open())
 		{
 			LOG(LogLevel::Error) << "Could not update localisation text file";
@@ -23,6 +23,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "../Configuration.h"
 #include "HoI4StrategicRegion.h"
+#include "BufferedOutput.h"
 #include "log.h"
 #include "ParadoxParserUTF8.h"
 #include <fstream>
@@ -53,7 +54,7 @@ HoI4StrategicRegion::HoI4StrategicRegion(string _filename)
 
 void HoI4StrategicRegion::output(string path)
 {
-	ofstream out(path + filename);
+	buffered_output::file out(path + filename);
 	if (!out.is_open())
 	{
 		LOG(LogLevel::Error) << "Could not open " << path << filename;
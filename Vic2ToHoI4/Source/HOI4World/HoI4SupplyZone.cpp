@@ -22,6 +22,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 #include "HoI4SupplyZone.h"
+#include "BufferedOutput.h"
 #include "log.h"
 #include "../Configuration.h"
 #include <fstream>
@@ -38,7 +39,7 @@ HoI4SupplyZone::HoI4SupplyZone(int _ID, int _value)
 void HoI4SupplyZone::output(string _filename)
 {
 	string filename("Output/" + Configuration::getOutputName() + "/map/supplyareas/" + _filename);
-	ofstream out(filename);
+	buffered_output::file out(filename);
 	if (!out.is_open())
 	{
 		LOG(LogLevel::Error) << "Could not open \"output/input/map/supplyareas/" + _filename;
@@ -35,7 +35,7 @@ using namespace std;
 
 
 
-HoI4SupplyZones::HoI4SupplyZones(map<int, vector<int>> defaultStateToProvinceMap)
+HoI4SupplyZones::HoI4SupplyZones(const map<int, vector<int>>& defaultStateToProvinceMap)
 {
 	LOG(LogLevel::Info) << "Importing supply zones";
 
@@ -86,12 +86,6 @@ void HoI4SupplyZones::mapProvincesToSupplyZone(int ID, Object* supplyAreaObj, co
 
 void HoI4SupplyZones::output()
 {
-	if (!Utils::TryCreateFolder("Output/" + Configuration::getOutputName() + "/map/supplyareas"))
-	{
-		LOG(LogLevel::Error) << "Could not create \"Output/" + Configuration::getOutputName() + "/map/supplyareas";
-		exit(-1);
-	}
-
 	for (auto zone: supplyZones)
 	{
 		auto filenameMap = supplyZonesFilenames.find(zone.first);
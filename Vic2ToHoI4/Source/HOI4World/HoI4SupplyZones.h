@@ -42,7 +42,7 @@ class Object;
 class HoI4SupplyZones
 {
 	public:
-		HoI4SupplyZones(map<int, vector<int>> HoI4DefaultStateToProvinceMap);
+		HoI4SupplyZones(const map<int, vector<int>>& HoI4DefaultStateToProvinceMap);
 		void output();
 		void convertSupplyZones(const HoI4States* states);
 
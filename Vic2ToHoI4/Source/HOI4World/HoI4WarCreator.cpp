@@ -23,6 +23,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "HoI4WarCreator.h"
 #include "Log.h"
+#include "HoI4CapitalGrid.h"
 #include "HoI4Events.h"
 #include "HoI4Faction.h"
 #include "HoI4Focus.h"
@@ -33,6 +34,26 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
+// These are defined here rather than left implicit, as the header can't see a full HoI4CapitalGrid to delete
+HoI4WarCreator::HoI4WarCreator():
+	genericFocusTree(nullptr),
+	theWorld(nullptr),
+	capitalGrid(),
+	AggressorFactions(),
+	WorldTargetMap(),
+	axisLeader(),
+	alliesLeader(),
+	cominternLeader(),
+	provinceToOwnerMap()
+{
+}
+
+
+HoI4WarCreator::~HoI4WarCreator()
+{
+}
+
+
 void HoI4WarCreator::generateWars(HoI4World* world)
 {
 	theWorld = world;
@@ -43,6 +64,7 @@ void HoI4WarCreator::generateWars(HoI4World* world)
 	genericFocusTree->addGenericFocusTree();
 
 	determineProvinceOwners();
+	capitalGrid.reset(new HoI4CapitalGrid(theWorld->getCountries(), theWorld->getStates()));
 	fillCountryProvinces();
 	addAllTargetsToWorldTargetMap();
 	double worldStrength = calculateWorldStrength(AILog);
@@ -244,7 +266,7 @@ void HoI4WarCreator::generateAdditionalWars(ofstream& AILog, vector<HoI4Country*
 }
 
 
-vector<HoI4Country*> HoI4WarCreator::calculateEvilness(vector<HoI4Country*> LeaderCountries)
+vector<HoI4Country*> HoI4WarCreator::calculateEvilness(const vector<HoI4Country*>& LeaderCountries)
 {
 	map<double, HoI4Country*> GCEvilness;
 	vector<HoI4Country*> GCEvilnessSorted;
@@ -407,16 +429,15 @@ vector<HoI4Country*> HoI4WarCreator::GetMorePossibleAllies(HoI4Country* CountryT
 	set<string> currentAllies = CountryThatWantsAllies->getAllies();
 	//set<string> currentAllies = CountryThatWantsAllies->getAllies();
 	vector<HoI4Country*> CountriesWithin500Miles; //Rename to actual distance
-	for (auto country : theWorld->getCountries())
+	for (auto country : capitalGrid->getCountriesWithin(CountryThatWantsAllies, 500))
 	{
 		if (country.second->getProvinceCount() != 0)
 		{
 			HoI4Country* country2 = country.second;
-			if (getDistanceBetweenCountries(CountryThatWantsAllies, country2) <= 500)
-				if (std::find(currentAllies.begin(), currentAllies.end(), country2->getTag()) == currentAllies.end())
-				{
-					CountriesWithin500Miles.push_back(country2);
-				}
+			if (std::find(currentAllies.begin(), currentAllies.end(), country2->getTag()) == currentAllies.end())
+			{
+				CountriesWithin500Miles.push_back(country2);
+			}
 		}
 	}
 	string yourgovernment = CountryThatWantsAllies->getGovernment();
@@ -482,109 +503,11 @@ vector<HoI4Country*> HoI4WarCreator::GetMorePossibleAllies(HoI4Country* CountryT
 
 double HoI4WarCreator::getDistanceBetweenCountries(const HoI4Country* country1, const HoI4Country* country2)
 {
-	if (!bothCountriesHaveCapitals(country1, country2))
-	{
-		return 100000;
-	}
-
-	pair<int, int> country1Position = getCapitalPosition(country1);
-	pair<int, int> country2Position = getCapitalPosition(country2);
-
-	return getDistanceBetweenPoints(country1Position, country2Position);
-}
-
-
-bool HoI4WarCreator::bothCountriesHaveCapitals(const HoI4Country* Country1, const HoI4Country* Country2)
-{
-	return (Country1->getCapitalProv() != 0) && (Country2->getCapitalProv() != 0);
+	return capitalGrid->getDistanceBetweenCountries(country1, country2);
 }
 
 
-pair<int, int> HoI4WarCreator::getCapitalPosition(const HoI4Country* country)
-{
-	auto capitalState = theWorld->getStates().find(country->getCapitalProv());
-	int capitalProvince = *(capitalState->second->getProvinces().begin());
-	return getProvincePosition(capitalProvince);
-}
-
-
-pair<int, int> HoI4WarCreator::getProvincePosition(int provinceNum)
-{
-	if (provincePositions.size() == 0)
-	{
-		establishProvincePositions();
-	}
-
-	auto itr = provincePositions.find(provinceNum);
-	return itr->second;
-}
-
-
-void HoI4WarCreator::establishProvincePositions()
-{
-	ifstream positionsFile("positions.txt");
-	if (!positionsFile.is_open())
-	{
-		LOG(LogLevel::Error) << "Could not open positions.txt";
-		exit(-1);
-	}
-
-	string line;
-	while (getline(positionsFile, line))
-	{
-		processPositionLine(line);
-	}
-
-	positionsFile.close();
-}
-
-
-void HoI4WarCreator::processPositionLine(const string& line)
-{
-	vector<string> tokenizedLine = tokenizeLine(line);
-	addProvincePosition(tokenizedLine);
-}
-
-
-void HoI4WarCreator::addProvincePosition(const vector<string>& tokenizedLine)
-{
-	int province = stoi(tokenizedLine[0]);
-	int x = stoi(tokenizedLine[2]);
-	int y = stoi(tokenizedLine[4]);
-
-	provincePositions.insert(make_pair(province, make_pair(x, y)));
-}
-
-
-vector<string> HoI4WarCreator::tokenizeLine(const string& line)
-{
-	vector<string> parts;
-	stringstream ss(line);
-	string tok;
-	while (getline(ss, tok, ';'))
-	{
-		parts.push_back(tok);
-	}
-
-	return parts;
-}
-
-
-double HoI4WarCreator::getDistanceBetweenPoints(pair<int, int> point1, pair<int, int> point2)
-{
-	int xDistance = abs(point2.first - point1.first);
-	if (xDistance > 2625)
-	{
-		xDistance = 5250 - xDistance;
-	}
-
-	int yDistance = point2.second - point1.second;
-
-	return sqrt(pow(xDistance, 2) + pow(yDistance, 2));
-}
-
-
-double HoI4WarCreator::GetFactionStrengthWithDistance(HoI4Country* HomeCountry, vector<HoI4Country*> Faction, double time)
+double HoI4WarCreator::GetFactionStrengthWithDistance(HoI4Country* HomeCountry, const vector<HoI4Country*>& Faction, double time)
 {
 	double strength = 0.0;
 	for (auto country: Faction)
@@ -681,24 +604,9 @@ map<string, HoI4Country*> HoI4WarCreator::getImmediateNeighbors(const HoI4Countr
 
 map<string, HoI4Country*> HoI4WarCreator::getNearbyCountries(const HoI4Country* checkingCountry)
 {
-	map<string, HoI4Country*> neighbors;
-
-	for (auto countryItr: theWorld->getCountries())
-	{
-		HoI4Country* country = countryItr.second;
-		if (country->getCapitalProv() != 0)
-		{
-			//IMPROVE
-			//need to get further neighbors, as well as countries without capital in an area
-			double distance = getDistanceBetweenCountries(checkingCountry, country);
-			if (distance <= 500)
-			{
-				neighbors.insert(countryItr);
-			}
-		}
-	}
-
-	return neighbors;
+	//IMPROVE
+	//need to get further neighbors, as well as countries without capital in an area
+	return capitalGrid->getCountriesWithin(checkingCountry, 500);
 }
 
 
@@ -2011,15 +1919,11 @@ map<string, HoI4Country*> HoI4WarCreator::findFarNeighbors(const HoI4Country* co
 
 	if (farNeighbors.size() == 0) // find all nearby countries
 	{
-		for (auto otherCountry: theWorld->getCountries())
+		for (auto otherCountry: capitalGrid->getCountriesWithin(country, 1000))
 		{
-			if (otherCountry.second->getCapitalProv() != 0)
+			if (otherCountry.second->getProvinceCount() > 0)
 			{
-				double distance = getDistanceBetweenCountries(country, otherCountry.second);
-				if ((distance <= 1000) && (otherCountry.second->getProvinceCount() > 0))
-				{
-					farNeighbors.insert(otherCountry);
-				}
+				farNeighbors.insert(otherCountry);
 			}
 		}
 	}
@@ -23,11 +23,14 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include <fstream>
 #include <map>
+#include <memory>
 #include <string>
 #include "HoI4Country.h"
+#include "ProvinceIndexed.h"
 using namespace std;
 
 
+class HoI4CapitalGrid;
 class HoI4World;
 
 
@@ -35,6 +38,8 @@ class HoI4World;
 class HoI4WarCreator
 {
 	public:
+		HoI4WarCreator();
+		~HoI4WarCreator();
 		void generateWars(HoI4World* world);
 
 	private:
@@ -53,7 +58,7 @@ class HoI4WarCreator
 		vector<HoI4Faction*> communistWarCreator(HoI4Country* country, ofstream& AILog);
 		vector<HoI4Faction*> democracyWarCreator(HoI4Country* country);
 		vector<HoI4Faction*> MonarchyWarCreator(HoI4Country* country);
-		vector<HoI4Country*> calculateEvilness(vector<HoI4Country*> LeaderCountries);
+		vector<HoI4Country*> calculateEvilness(const vector<HoI4Country*>& LeaderCountries);
 
 		vector<HoI4Country*> findWeakNeighbors(const HoI4Country* country);
 		map<string, HoI4Country*> findCloseNeighbors(const HoI4Country* country);
@@ -70,15 +75,7 @@ class HoI4WarCreator
 		string HowToTakeLand(HoI4Country * TargetCountry, HoI4Country * AttackingCountry, double time);
 		vector<HoI4Country*> GetMorePossibleAllies(HoI4Country * CountryThatWantsAllies);
 		double getDistanceBetweenCountries(const HoI4Country* Country1, const HoI4Country* Country2);
-		bool bothCountriesHaveCapitals(const HoI4Country* Country1, const HoI4Country* Country2);
-		pair<int, int> getCapitalPosition(const HoI4Country* country);
-		pair<int, int> getProvincePosition(int provinceNum);
-		void establishProvincePositions();
-		void processPositionLine(const string& line);
-		vector<string> tokenizeLine(const string& line);
-		void addProvincePosition(const vector<string>& tokenizedLine);
-		double getDistanceBetweenPoints(pair<int, int> point1, pair<int, int> point2);
-		double GetFactionStrengthWithDistance(HoI4Country* HomeCountry, vector<HoI4Country*> Faction, double time);
+		double GetFactionStrengthWithDistance(HoI4Country* HomeCountry, const vector<HoI4Country*>& Faction, double time);
 		HoI4Faction* findFaction(HoI4Country * checkingCountry);
 
 		map<string, HoI4Country*> getNeighbors(const HoI4Country* checkingCountry);
@@ -88,13 +85,13 @@ class HoI4WarCreator
 
 		HoI4FocusTree* genericFocusTree;
 		HoI4World* theWorld;
+		unique_ptr<HoI4CapitalGrid> capitalGrid;	// where every country's capital is, once generateWars has started
 
 		vector<HoI4Country*> AggressorFactions;
 		map<HoI4Country*, vector<HoI4Country*>> WorldTargetMap;
-		map<int, pair<int, int>> provincePositions;
 
 		string axisLeader;
 		string alliesLeader;
 		string cominternLeader;
-		map<int, string> provinceToOwnerMap;
+		provinceIndexedMap<string> provinceToOwnerMap;
 };
\ No newline at end of file
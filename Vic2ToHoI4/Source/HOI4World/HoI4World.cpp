@@ -28,10 +28,12 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <unordered_map>
 #include <boost/filesystem.hpp>
 #include <boost/foreach.hpp> 
+#include "BufferedOutput.h"
 #include "ParadoxParser8859_15.h"
 #include "ParadoxParserUTF8.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
+#include "ParallelFor.h"
 #include "../Configuration.h"
 #include "../V2World/Vic2Agreement.h"
 #include "../V2World/V2Diplomacy.h"
@@ -134,45 +136,78 @@ void HoI4World::convertCountries()
 	initNamesMapping(namesMap);
 	initPortraitMapping(portraitMap);
 
-	map<int, int> leaderMap;
-
+	// the countries are initialized in parallel, then everything that draws on state shared between countries (leader IDs, random names,
+	// capital states and localisations) is done for each country in the same order as before
+	vector<pair<const V2Country*, HoI4Country*>> conversions;	// the source and destination of each country, with no destination if it isn't converted
 	for (auto sourceItr : sourceWorld->getCountries())
 	{
-		convertCountry(sourceItr, leaderMap, governmentJobs, cultureMap, landPersonalityMap, seaPersonalityMap, landBackgroundMap, seaBackgroundMap);
+		// don't convert rebels
+		if (sourceItr.first != "REB")
+		{
+			conversions.push_back(make_pair(sourceItr.second, createCountry(sourceItr)));
+		}
+	}
+
+	Utils::parallelFor(conversions.size(), [&](size_t i)
+	{
+		if (conversions[i].second != nullptr)
+		{
+			V2Party* rulingParty = conversions[i].first->getRulingParty(sourceWorld->getParties());
+			conversions[i].second->initFromV2Country(*sourceWorld, conversions[i].first, rulingParty->ideology, cultureMap, states->getProvinceToStateIDMap(), states->getStates());
+		}
+	});
+
+	for (auto conversion : conversions)
+	{
+		HoI4Country* destCountry = conversion.second;
+		string HoI4Tag;
+		if (destCountry != nullptr)
+		{
+			destCountry->initLeadersFromV2Country(governmentJobs, namesMap, portraitMap, landPersonalityMap, seaPersonalityMap, landBackgroundMap, seaBackgroundMap);
+			destCountry->setCapitalInCapitalState(states->getStates());
+			HoI4Tag = destCountry->getTag();
+			countries.insert(make_pair(HoI4Tag, destCountry));
+		}
+		localisation.readFromCountry(conversion.first, HoI4Tag);
 	}
 	localisation.addNonenglishCountryLocalisations();
 }
 
 
-void HoI4World::convertCountry(pair<string, V2Country*> country, map<int, int>& leaderMap, governmentJobsMap governmentJobs, const cultureMapping& cultureMap, personalityMap& landPersonalityMap, personalityMap& seaPersonalityMap, backgroundMap& landBackgroundMap, backgroundMap& seaBackgroundMap)
+HoI4Country* HoI4World::createCountry(const pair<string, V2Country*>& country)
 {
-	// don't convert rebels
-	if (country.first == "REB")
+	const std::string& HoI4Tag = CountryMapper::getHoI4Tag(country.first);
+	if (HoI4Tag.empty())
 	{
-		return;
+		LOG(LogLevel::Warning) << "Could not convert V2 tag " << country.first << " to HoI4";
+		return nullptr;
 	}
 
-	HoI4Country* destCountry = NULL;
-	const std::string& HoI4Tag = CountryMapper::getHoI4Tag(country.first);
-	if (!HoI4Tag.empty())
+	V2Party* rulingParty = country.second->getRulingParty(sourceWorld->getParties());
+	if (rulingParty == NULL)
 	{
-		std::string countryFileName = '/' + country.second->getName("english") + ".txt";
-		destCountry = new HoI4Country(HoI4Tag, countryFileName, this, true);
-		V2Party* rulingParty = country.second->getRulingParty(sourceWorld->getParties());
-		if (rulingParty == NULL)
-		{
-			LOG(LogLevel::Error) << "Could not find the ruling party for " << country.first << ". Were all mods correctly included?";
-			exit(-1);
-		}
-		destCountry->initFromV2Country(*sourceWorld, country.second, rulingParty->ideology, leaderMap, governmentJobs, namesMap, portraitMap, cultureMap, landPersonalityMap, seaPersonalityMap, landBackgroundMap, seaBackgroundMap, states->getProvinceToStateIDMap(), states->getStates());
-		countries.insert(make_pair(HoI4Tag, destCountry));
+		LOG(LogLevel::Error) << "Could not find the ruling party for " << country.first << ". Were all mods correctly included?";
+		exit(-1);
 	}
-	else
+
+	std::string countryFileName = '/' + country.second->getName("english") + ".txt";
+	return new HoI4Country(HoI4Tag, countryFileName, this, true);
+}
+
+
+// Calls convert for every country, several countries at a time. convert must only change the country it's given.
+void HoI4World::forEachCountryInParallel(function<void(HoI4Country*)> convert)
+{
+	vector<HoI4Country*> countriesToConvert;
+	for (auto country: countries)
 	{
-		LOG(LogLevel::Warning) << "Could not convert V2 tag " << country.first << " to HoI4";
+		countriesToConvert.push_back(country.second);
 	}
 
-	localisation.readFromCountry(country.second, HoI4Tag);
+	Utils::parallelFor(countriesToConvert.size(), [&](size_t i)
+	{
+		convert(countriesToConvert[i]);
+	});
 }
 
 
@@ -254,7 +289,7 @@ map<string, double> HoI4World::getIndustrialWorkersPerCountry()
 }
 
 
-double HoI4World::getTotalWorldWorkers(map<string, double> industrialWorkersPerCountry)
+double HoI4World::getTotalWorldWorkers(const map<string, double>& industrialWorkersPerCountry)
 {
 	double totalWorldWorkers = 0.0;
 	for (auto countryWorkers: industrialWorkersPerCountry)
@@ -266,7 +301,7 @@ double HoI4World::getTotalWorldWorkers(map<string, double> industrialWorkersPerC
 }
 
 
-map<string, double> HoI4World::adjustWorkers(map<string, double> industrialWorkersPerCountry, double totalWorldWorkers)
+map<string, double> HoI4World::adjustWorkers(const map<string, double>& industrialWorkersPerCountry, double totalWorldWorkers)
 {
 	double meanWorkersPerCountry = totalWorldWorkers / industrialWorkersPerCountry.size();
 
@@ -289,7 +324,7 @@ map<string, double> HoI4World::adjustWorkers(map<string, double> industrialWorke
 }
 
 
-double HoI4World::getWorldwideWorkerFactoryRatio(map<string, double> workersInCountries, double totalWorldWorkers)
+double HoI4World::getWorldwideWorkerFactoryRatio(const map<string, double>& workersInCountries, double totalWorldWorkers)
 {
 	double baseIndustry = 0.0;
 	for (auto countryWorkers: workersInCountries)
@@ -305,7 +340,7 @@ double HoI4World::getWorldwideWorkerFactoryRatio(map<string, double> workersInCo
 }
 
 
-void HoI4World::putIndustryInStates(map<string, double> factoryWorkerRatios)
+void HoI4World::putIndustryInStates(const map<string, double>& factoryWorkerRatios)
 {
 	for (auto HoI4State : states->getStates())
 	{
@@ -519,19 +554,7 @@ void HoI4World::output() const
 {
 	LOG(LogLevel::Info) << "Outputting world";
 
-	string NFpath = "Output/" + Configuration::getOutputName() + "/common/national_focus";
-	if (!Utils::TryCreateFolder(NFpath))
-	{
-		LOG(LogLevel::Error) << "Could not create \"Output/" + Configuration::getOutputName() + "/common/national_focus\"";
-		exit(-1);
-	}
-	string eventpath = "Output/" + Configuration::getOutputName() + "/events";
-	if (!Utils::TryCreateFolder(eventpath))
-	{
-		LOG(LogLevel::Error) << "Could not create \"Output/" + Configuration::getOutputName() + "/events\"";
-		exit(-1);
-	}
-
+	createOutputFolders();
 	outputCommonCountries();
 	outputColorsfile();
 	//outputAutoexecLua();
@@ -543,37 +566,46 @@ void HoI4World::output() const
 	outputCountries();
 	buildings->output();
 	events->output();
-}
 
-
-void HoI4World::outputCommonCountries() const
-{
-	// Create common\countries path.
-	string countriesPath = "Output/" + Configuration::getOutputName() + "/common";
-	/*if (!Utils::TryCreateFolder(countriesPath))
-	{
-		LOG(LogLevel::Error) << "Could not create \"Output/" + Configuration::getOutputName() + "/common\"";
-		exit(-1);
-	}*/
-	if (!Utils::TryCreateFolder(countriesPath + "/countries"))
+	// the files are written in the background, so any trouble writing them only shows up here
+	if (!buffered_output::finish())
 	{
-		LOG(LogLevel::Error) << "Could not create \"Output/" + Configuration::getOutputName() + "/common/countries\"";
+		LOG(LogLevel::Error) << "Could not write all of Output/" << Configuration::getOutputName();
 		exit(-1);
 	}
-	if (!Utils::TryCreateFolder(countriesPath + "/country_tags"))
-	{
-		LOG(LogLevel::Error) << "Could not create \"Output/" + Configuration::getOutputName() + "/common/country_tags\"";
+}
+
+
+// All the folders are created at once, before any files are queued to be written into them
+void HoI4World::createOutputFolders() const
+{
+	string outputPath = "Output/" + Configuration::getOutputName();
+	vector<string> folders = {
+		outputPath + "/common/countries",
+		outputPath + "/common/country_tags",
+		outputPath + "/common/national_focus",
+		outputPath + "/common/opinion_modifiers",
+		outputPath + "/events",
+		outputPath + "/history/countries",
+		outputPath + "/history/states",
+		outputPath + "/history/units",
+		outputPath + "/localisation",
+		outputPath + "/map/strategicregions",
+		outputPath + "/map/supplyareas"
+	};
+	if (!buffered_output::createFolders(folders))
+	{
+		LOG(LogLevel::Error) << "Could not create the output folders";
 		exit(-1);
 	}
+}
 
+
+void HoI4World::outputCommonCountries() const
+{
 	// Output common\countries.txt
 	LOG(LogLevel::Debug) << "Writing countries file";
-	FILE* allCountriesFile;
-	if (fopen_s(&allCountriesFile, ("Output/" + Configuration::getOutputName() + "/common/country_tags/00_countries.txt").c_str(), "w") != 0)
-	{
-		LOG(LogLevel::Error) << "Could not create countries file";
-		exit(-1);
-	}
+	buffered_output::file allCountriesFile("Output/" + Configuration::getOutputName() + "/common/country_tags/00_countries.txt");
 
 	for (auto countryItr : countries)
 	{
@@ -582,19 +614,19 @@ void HoI4World::outputCommonCountries() const
 			countryItr.second->outputToCommonCountriesFile(allCountriesFile);
 		}
 	}
-	fprintf(allCountriesFile, "\n");
-	fclose(allCountriesFile);
+	allCountriesFile << "\n";
+	allCountriesFile.close();
 }
 
 
 void HoI4World::outputColorsfile() const
 {
 
-	ofstream output;
+	buffered_output::file output;
 	output.open(("Output/" + Configuration::getOutputName() + "/common/countries/colors.txt"));
 	if (!output.is_open())
 	{
-		Log(LogLevel::Error) << "Could not open Output/" << Configuration::getOutputName() << "/common/countries/colors.txt";
+		LOG(LogLevel::Error) << "Could not open Output/" << Configuration::getOutputName() << "/common/countries/colors.txt";
 		exit(-1);
 	}
 
@@ -646,12 +678,6 @@ void HoI4World::outputLocalisations() const
 	// Create localisations for all new countries. We don't actually know the names yet so we just use the tags as the names.
 	LOG(LogLevel::Debug) << "Writing localisation text";
 	string localisationPath = "Output/" + Configuration::getOutputName() + "/localisation";
-	if (!Utils::TryCreateFolder(localisationPath))
-	{
-		LOG(LogLevel::Error) << "Could not create localisation folder";
-		exit(-1);
-	}
-
 	localisation.output(localisationPath);
 }
 
@@ -660,15 +686,8 @@ void HoI4World::outputMap() const
 {
 	LOG(LogLevel::Debug) << "Writing Map Info";
 
-	// create the map folder
-	if (!Utils::TryCreateFolder("Output/" + Configuration::getOutputName() + "/map"))
-	{
-		LOG(LogLevel::Error) << "Could not create \"Output/" + Configuration::getOutputName() + "/map";
-		exit(-1);
-	}
-
 	// create the rocket sites file
-	ofstream rocketSitesFile("Output/" + Configuration::getOutputName() + "/map/rocketsites.txt");
+	buffered_output::file rocketSitesFile("Output/" + Configuration::getOutputName() + "/map/rocketsites.txt");
 	if (!rocketSitesFile.is_open())
 	{
 		LOG(LogLevel::Error) << "Could not create Output/" << Configuration::getOutputName() << "/map/rocketsites.txt";
@@ -682,7 +701,7 @@ void HoI4World::outputMap() const
 	rocketSitesFile.close();
 
 	// create the airports file
-	ofstream airportsFile("Output/" + Configuration::getOutputName() + "/map/airports.txt");
+	buffered_output::file airportsFile("Output/" + Configuration::getOutputName() + "/map/airports.txt");
 	if (!airportsFile.is_open())
 	{
 		LOG(LogLevel::Error) << "Could not create Output/" << Configuration::getOutputName() << "/map/airports.txt";
@@ -696,11 +715,6 @@ void HoI4World::outputMap() const
 	airportsFile.close();
 
 	// output strategic regions
-	if (!Utils::TryCreateFolder("Output/" + Configuration::getOutputName() + "/map/strategicregions"))
-	{
-		LOG(LogLevel::Error) << "Could not create \"Output/" + Configuration::getOutputName() + "/map/strategicregions";
-		exit(-1);
-	}
 	for (auto strategicRegion : strategicRegions)
 	{
 		strategicRegion.second->output("Output/" + Configuration::getOutputName() + "/map/strategicregions/");
@@ -713,12 +727,6 @@ void HoI4World::outputHistory() const
 	states->output();
 
 	LOG(LogLevel::Debug) << "Writing countries";
-	string unitsPath = "Output/" + Configuration::getOutputName() + "/history/units";
-	if (!Utils::TryCreateFolder(unitsPath))
-	{
-		LOG(LogLevel::Error) << "Could not create \"Output/" + Configuration::getOutputName() + "/history/units";
-		exit(-1);
-	}
 	/*for (auto countryItr: countries)
 	{
 		countryItr.second->output(states->getStates(), );
@@ -881,10 +889,10 @@ void HoI4World::convertTechs()
 	}
 
 
-	for (auto dstCountry : countries)
+	forEachCountryInParallel([&](HoI4Country* dstCountry)
 	{
-		const V2Country*	sourceCountry = dstCountry.second->getSourceCountry();
-		vector<string>	techs = sourceCountry->getTechs();
+		const V2Country*	sourceCountry = dstCountry->getSourceCountry();
+		const vector<string>&	techs = sourceCountry->getTechs();
 
 		for (auto techName : techs)
 		{
@@ -893,12 +901,12 @@ void HoI4World::convertTechs()
 			{
 				for (auto HoI4TechItr : mapItr->second)
 				{
-					dstCountry.second->setTechnology(HoI4TechItr.first, HoI4TechItr.second);
+					dstCountry->setTechnology(HoI4TechItr.first, HoI4TechItr.second);
 				}
 			}
 		}
 
-		auto srcInventions = sourceCountry->getInventions();
+		auto& srcInventions = sourceCountry->getInventions();
 		for (auto invItr : srcInventions)
 		{
 			auto mapItr = invTechMap.find(invItr);
@@ -910,11 +918,11 @@ void HoI4World::convertTechs()
 			{
 				for (auto HoI4TechItr : mapItr->second)
 				{
-					dstCountry.second->setTechnology(HoI4TechItr.first, HoI4TechItr.second);
+					dstCountry->setTechnology(HoI4TechItr.first, HoI4TechItr.second);
 				}
 			}
 		}
-	}
+	});
 }
 
 
@@ -949,7 +957,7 @@ vector<int> HoI4World::getPortProvinces(const vector<int>& locationCandidates)
 	vector<int> newLocationCandidates;
 	for (auto litr : locationCandidates)
 	{
-		map<int, HoI4Province*>::const_iterator provinceItr = provinces.find(litr);
+		provinceIndexedMap<HoI4Province*>::const_iterator provinceItr = provinces.find(litr);
 		if ((provinceItr != provinces.end()) && (provinceItr->second->hasNavalBase()))
 		{
 			newLocationCandidates.push_back(litr);
@@ -1010,10 +1018,10 @@ void HoI4World::convertArmies()
 {
 	LOG(LogLevel::Info) << "Converting armies";
 
-	for (auto country : countries)
+	forEachCountryInParallel([&](HoI4Country* country)
 	{
-		country.second->convertArmyDivisions();
-	}
+		country->convertArmyDivisions();
+	});
 }
 
 
@@ -1021,10 +1029,10 @@ void HoI4World::convertNavies()
 {
 	LOG(LogLevel::Info) << "Converting navies";
 
-	for (auto country : countries)
+	forEachCountryInParallel([&](HoI4Country* country)
 	{
-		country.second->convertNavy(states->getStates());
-	}
+		country->convertNavy(states->getStates());
+	});
 }
 
 
@@ -1032,10 +1040,10 @@ void HoI4World::convertAirforces()
 {
 	LOG(LogLevel::Info) << "Converting air forces";
 
-	for (auto country : countries)
+	forEachCountryInParallel([&](HoI4Country* country)
 	{
-		country.second->convertAirforce();
-	}
+		country->convertAirforce();
+	});
 }
 
 
@@ -1270,13 +1278,7 @@ void HoI4World::convertRelations()
 
 void HoI4World::outputRelations() const
 {
-	if (!Utils::TryCreateFolder("Output/" + Configuration::getOutputName() + "/common/opinion_modifiers"))
-	{
-		Log(LogLevel::Error) << "Could not create Output/" + Configuration::getOutputName() + "/common/opinion_modifiers/";
-		exit(-1);
-	}
-
-	ofstream out("Output/" + Configuration::getOutputName() + "/common/opinion_modifiers/01_opinion_modifiers.txt");
+	buffered_output::file out("Output/" + Configuration::getOutputName() + "/common/opinion_modifiers/01_opinion_modifiers.txt");
 	if (!out.is_open())
 	{
 		LOG(LogLevel::Error) << "Could not create 01_opinion_modifiers.txt.";
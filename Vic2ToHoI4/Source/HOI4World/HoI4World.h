@@ -24,6 +24,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #ifndef HoI4WORLD_H_
 #define HoI4WORLD_H_
 
+#include <functional>
 #include <string>
 #include "HoI4Buildings.h"
 #include "HoI4Country.h"
@@ -33,6 +34,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "HoI4Localisation.h"
 #include "HoI4States.h"
 #include "HoI4StrategicRegion.h"
+#include "ProvinceIndexed.h"
 
 
 
@@ -62,10 +64,10 @@ class HoI4World
 
 		void outputRelations() const;
 
-		map<string, HoI4Country*> getCountries()	const { return countries; }
-		vector<HoI4Country*> getGreatPowers() const { return greatPowers; }
-		map<int, HoI4State*> getStates() const { return states->getStates(); }
-		vector<HoI4Faction*> getFactions() const { return factions; }
+		const map<string, HoI4Country*>& getCountries()	const { return countries; }
+		const vector<HoI4Country*>& getGreatPowers() const { return greatPowers; }
+		const map<int, HoI4State*>& getStates() const { return states->getStates(); }
+		const vector<HoI4Faction*>& getFactions() const { return factions; }
 		HoI4Events* getEvents() const { return events; }
 
 	private:
@@ -73,16 +75,17 @@ class HoI4World
 		void convertNavalBases();
 
 		void convertCountries();
-		void convertCountry(pair<string, V2Country*> country, map<int, int>& leaderMap, governmentJobsMap governmentJobs, const cultureMapping& cultureMap, personalityMap& landPersonalityMap, personalityMap& seaPersonalityMap, backgroundMap& landBackgroundMap, backgroundMap& seaBackgroundMap);
+		HoI4Country* createCountry(const pair<string, V2Country*>& country);
+		void forEachCountryInParallel(function<void(HoI4Country*)> convert);
 
 		void convertIndustry();
 		void addStatesToCountries();
 		map<string, double> calculateFactoryWorkerRatios();
 		map<string, double> getIndustrialWorkersPerCountry();
-		double getTotalWorldWorkers(map<string, double> industrialWorkersPerCountry);
-		map<string, double> adjustWorkers(map<string, double> industrialWorkersPerCountry, double totalWorldWorkers);
-		double getWorldwideWorkerFactoryRatio(map<string, double> workersInCountries, double totalWorldWorkers);
-		void putIndustryInStates(map<string, double> factoryWorkerRatios);
+		double getTotalWorldWorkers(const map<string, double>& industrialWorkersPerCountry);
+		map<string, double> adjustWorkers(const map<string, double>& industrialWorkersPerCountry, double totalWorldWorkers);
+		double getWorldwideWorkerFactoryRatio(const map<string, double>& workersInCountries, double totalWorldWorkers);
+		void putIndustryInStates(const map<string, double>& factoryWorkerRatios);
 		void calculateIndustryInCountries();
 		void reportIndustryLevels();
 		void reportCountryIndustry();
@@ -121,6 +124,7 @@ class HoI4World
 		string returnSphereLeader(HoI4Country* possibleSphereling);
 		bool governmentsAllowFaction(string leaderGovernment, string allyGovernment);
 
+		void createOutputFolders() const;
 		void outputCommonCountries() const;
 		void outputColorsfile() const;
 		void outputAutoexecLua() const;
@@ -138,7 +142,7 @@ class HoI4World
 
 		HoI4States* states;
 		
-		map<int, HoI4Province*>		provinces;
+		provinceIndexedMap<HoI4Province*>	provinces;
 		map<string, HoI4Country*>	countries;
 		map<string, HoI4Country*> landedCountries;
 		HoI4Diplomacy					diplomacy;
@@ -147,7 +151,7 @@ class HoI4World
 		// map items
 		map<int, string>						continents;  // < province, continent >
 		map<int, HoI4StrategicRegion*>	strategicRegions;
-		map<int, int>							provinceToStratRegionMap;
+		provinceIndexedMap<int>				provinceToStratRegionMap;
 
 		HoI4Localisation				localisation;
 
@@ -26,6 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "log.h"
 #include "..\Configuration.h"
 #include "ProvinceNeighborMapper.h"
+#include "MapTopologyCache.h"
 
 
 
@@ -35,6 +36,12 @@ coastalHoI4ProvincesMapper* coastalHoI4ProvincesMapper::instance = NULL;
 
 coastalHoI4ProvincesMapper::coastalHoI4ProvincesMapper()
 {
+	if (mapTopologyCache::isValid())
+	{
+		coastalProvinces = mapTopologyCache::getCoastalProvinces();
+		return;
+	}
+
 	map<int, province> provinces = getProvinces();
 
 	for (auto province: provinces)
@@ -0,0 +1,393 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#include "MapTopologyCache.h"
+#include "CoastalHoI4Provinces.h"
+#include "log.h"
+#include "../Configuration.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+
+
+mapTopologyCache* mapTopologyCache::instance = nullptr;
+
+
+
+static const char cacheMagic[8] = { 'H', 'O', 'I', '4', 'T', 'O', 'P', 'O' };
+static const uint32_t formatVersion = 2;	// bump this whenever the layout below changes
+
+// the cache starts with this header, followed by int32_t arrays of neighborOffsets, neighbors, borderCenters, coastalSeas and positions,
+// and then the flags
+struct cacheHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t numProvinces;	// one more than the highest province number
+	uint32_t numBorders;	// how many neighbors there are over all the provinces
+	uint32_t unused;	// keeps the source keys aligned
+	uint64_t sourceKeys[3][3];	// the size, modification time and hash of provinces.bmp, definition.csv and positions.txt
+};
+
+static const uint8_t coastalFlag = 1;
+static const uint8_t positionFlag = 2;
+
+
+static string getCachePath()
+{
+	return Utils::getCurrentDirectory() + "/cache/HoI4MapTopology.bin";
+}
+
+
+static vector<string> getSourcePaths()
+{
+	return {
+		Configuration::getHoI4Path() + "/map/provinces.bmp",
+		Configuration::getHoI4Path() + "/map/definition.csv",
+		"positions.txt"
+	};
+}
+
+
+static uint64_t getCacheSize(uint64_t numProvinces, uint64_t numBorders)
+{
+	return sizeof(cacheHeader) + sizeof(int32_t) * ((numProvinces + 1) + numBorders * 3 + numProvinces * 3) + numProvinces;
+}
+
+
+// A 64-bit FNV-1a hash
+static uint64_t hashBytes(const char* begin, const char* end)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (const char* current = begin; current < end; current++)
+	{
+		hash ^= static_cast<unsigned char>(*current);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+
+mapTopologyCache::mapTopologyCache():
+	valid(false),
+	file(),
+	numProvinces(0),
+	neighborOffsets(nullptr),
+	neighbors(nullptr),
+	borderCenters(nullptr),
+	coastalSeas(nullptr),
+	positions(nullptr),
+	flags(nullptr)
+{
+	file.reset(new Utils::mappedFile(getCachePath()));
+	if (!file->isOpen() || (file->getSize() < sizeof(cacheHeader)))
+	{
+		file.reset();
+		return;
+	}
+
+	cacheHeader header;
+	memcpy(&header, file->begin(), sizeof(header));
+	if ((memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0) || (header.version != formatVersion) || (file->getSize() != getCacheSize(header.numProvinces, header.numBorders)))
+	{
+		file.reset();
+		return;
+	}
+
+	vector<string> sourcePaths = getSourcePaths();
+	for (unsigned int i = 0; i < sourcePaths.size(); i++)
+	{
+		sourceKey cachedKey = { header.sourceKeys[i][0], header.sourceKeys[i][1], header.sourceKeys[i][2] };
+		if (!checkSource(sourcePaths[i], cachedKey))
+		{
+			LOG(LogLevel::Debug) << sourcePaths[i] << " has changed since the map was cached";
+			file.reset();
+			return;
+		}
+	}
+
+	numProvinces = header.numProvinces;
+	const int32_t* arrays = reinterpret_cast<const int32_t*>(file->begin() + sizeof(cacheHeader));
+	neighborOffsets = arrays;
+	neighbors = neighborOffsets + numProvinces + 1;
+	borderCenters = neighbors + header.numBorders;
+	coastalSeas = borderCenters + 2 * header.numBorders;
+	positions = coastalSeas + numProvinces;
+	flags = reinterpret_cast<const uint8_t*>(positions + 2 * numProvinces);
+
+	// the offsets are checked once here so that nothing reading the arrays can run off the end of them
+	for (uint32_t province = 0; province < numProvinces; province++)
+	{
+		if ((neighborOffsets[province] < 0) || (neighborOffsets[province] > neighborOffsets[province + 1]))
+		{
+			file.reset();
+			return;
+		}
+	}
+	if ((neighborOffsets[0] != 0) || (static_cast<uint32_t>(neighborOffsets[numProvinces]) != header.numBorders))
+	{
+		file.reset();
+		return;
+	}
+
+	LOG(LogLevel::Info) << "Using the cached map topology";
+	valid = true;
+}
+
+
+// A source matches its cached key if it's the same size and either hasn't been written since or still has the same contents
+bool mapTopologyCache::checkSource(const string& path, const sourceKey& cachedKey) const
+{
+	Utils::mappedFile source(path);
+	if (!source.isOpen() || (source.getSize() != cachedKey.size))
+	{
+		return false;
+	}
+	if (source.getModifiedTime() == cachedKey.modifiedTime)
+	{
+		return true;
+	}
+	return (hashBytes(source.begin(), source.end()) == cachedKey.hash);
+}
+
+
+mapTopologyCache::sourceKey mapTopologyCache::makeSourceKey(const string& path) const
+{
+	sourceKey key = { 0, 0, 0 };
+	Utils::mappedFile source(path);
+	if (source.isOpen())
+	{
+		key.size = source.getSize();
+		key.modifiedTime = source.getModifiedTime();
+		key.hash = hashBytes(source.begin(), source.end());
+	}
+	return key;
+}
+
+
+void mapTopologyCache::GetNeighbors(provinceIndexedLists<int>& provinceNeighbors, provinceIndexedLists<point>& provinceBorderCenters) const
+{
+	vector<point> centers;
+	for (uint32_t province = 0; province < numProvinces; province++)
+	{
+		int32_t first = neighborOffsets[province];
+		int32_t last = neighborOffsets[province + 1];
+		if (first == last)
+		{
+			continue;
+		}
+
+		centers.clear();
+		for (int32_t i = first; i < last; i++)
+		{
+			centers.push_back(make_pair(borderCenters[2 * i], borderCenters[2 * i + 1]));
+		}
+		provinceNeighbors.append(province, neighbors + first, neighbors + last);
+		provinceBorderCenters.append(province, centers.begin(), centers.end());
+	}
+}
+
+
+map<int, int> mapTopologyCache::GetCoastalProvinces() const
+{
+	map<int, int> coastalProvinces;
+	for (uint32_t province = 0; province < numProvinces; province++)
+	{
+		if (flags[province] & coastalFlag)
+		{
+			coastalProvinces.insert(coastalProvinces.end(), make_pair(province, coastalSeas[province]));
+		}
+	}
+	return coastalProvinces;
+}
+
+
+provinceIndexedMap<pair<int, int>> mapTopologyCache::GetProvincePositions() const
+{
+	if (!valid)
+	{
+		return readProvincePositions();
+	}
+
+	provinceIndexedMap<pair<int, int>> provincePositions;
+	for (uint32_t province = 0; province < numProvinces; province++)
+	{
+		if (flags[province] & positionFlag)
+		{
+			provincePositions.insert(make_pair(province, make_pair(positions[2 * province], positions[2 * province + 1])));
+		}
+	}
+	return provincePositions;
+}
+
+
+// Each line of positions.txt is the province number, then a field that isn't used, then the x, then another unused field, then the y
+provinceIndexedMap<pair<int, int>> mapTopologyCache::readProvincePositions() const
+{
+	ifstream positionsFile("positions.txt");
+	if (!positionsFile.is_open())
+	{
+		LOG(LogLevel::Error) << "Could not open positions.txt";
+		exit(-1);
+	}
+
+	provinceIndexedMap<pair<int, int>> provincePositions;
+	string line;
+	while (getline(positionsFile, line))
+	{
+		vector<string> parts;
+		stringstream ss(line);
+		string tok;
+		while (getline(ss, tok, ';'))
+		{
+			parts.push_back(tok);
+		}
+
+		int province = stoi(parts[0]);
+		int x = stoi(parts[2]);
+		int y = stoi(parts[4]);
+		provincePositions.insert(make_pair(province, make_pair(x, y)));
+	}
+
+	return provincePositions;
+}
+
+
+void mapTopologyCache::Save()
+{
+	if (valid)
+	{
+		return;
+	}
+
+	const provinceIndexedLists<int>& allNeighbors = provinceNeighborMapper::getAllNeighbors();
+	map<int, int> coastalProvinces = coastalHoI4ProvincesMapper::getCoastalProvinces();
+	provinceIndexedMap<pair<int, int>> provincePositions = readProvincePositions();
+
+	int maxProvince = 0;	// the highest province number with anything to cache
+	for (auto& province: allNeighbors)
+	{
+		maxProvince = max(maxProvince, province.first);
+	}
+	if (!coastalProvinces.empty())
+	{
+		maxProvince = max(maxProvince, coastalProvinces.rbegin()->first);
+	}
+	for (auto& province: provincePositions)
+	{
+		maxProvince = max(maxProvince, province.first);
+	}
+	uint32_t cachedProvinces = maxProvince + 1;	// the number of provinces in the cache
+	vector<int32_t> offsetArray(cachedProvinces + 1, 0);
+	vector<int32_t> neighborArray;
+	vector<int32_t> centerArray;
+	for (uint32_t province = 0; province < cachedProvinces; province++)
+	{
+		offsetArray[province] = neighborArray.size();
+		auto provinceNeighbors = allNeighbors.find(province);
+		if (provinceNeighbors != allNeighbors.end())
+		{
+			for (auto neighbor: provinceNeighbors->second)
+			{
+				point center = provinceNeighborMapper::getBorderCenter(province, neighbor);
+				neighborArray.push_back(neighbor);
+				centerArray.push_back(center.first);
+				centerArray.push_back(center.second);
+			}
+		}
+	}
+	offsetArray[cachedProvinces] = neighborArray.size();
+
+	vector<int32_t> coastalArray(cachedProvinces, 0);
+	vector<int32_t> positionArray(2 * cachedProvinces, 0);
+	vector<uint8_t> flagArray(cachedProvinces, 0);
+	for (auto province: coastalProvinces)
+	{
+		if (province.first >= 0)
+		{
+			flagArray[province.first] |= coastalFlag;
+			coastalArray[province.first] = province.second;
+		}
+	}
+	for (auto province: provincePositions)
+	{
+		if (province.first >= 0)
+		{
+			flagArray[province.first] |= positionFlag;
+			positionArray[2 * province.first] = province.second.first;
+			positionArray[2 * province.first + 1] = province.second.second;
+		}
+	}
+
+	cacheHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+	header.version = formatVersion;
+	header.numProvinces = cachedProvinces;
+	header.numBorders = neighborArray.size();
+	vector<string> sourcePaths = getSourcePaths();
+	for (unsigned int i = 0; i < sourcePaths.size(); i++)
+	{
+		sourceKey key = makeSourceKey(sourcePaths[i]);
+		header.sourceKeys[i][0] = key.size;
+		header.sourceKeys[i][1] = key.modifiedTime;
+		header.sourceKeys[i][2] = key.hash;
+	}
+
+	// the file is written under another name and then moved into place, so a reader never sees half of it
+	Utils::TryCreateFolder(Utils::getCurrentDirectory() + "/cache");
+	string cachePath = getCachePath();
+	string tempPath = cachePath + "." + to_string(Utils::getProcessID()) + ".tmp";
+	{
+		ofstream cacheFile(tempPath, ios::binary | ios::trunc);
+		if (!cacheFile.is_open())
+		{
+			LOG(LogLevel::Debug) << "Could not write the map topology cache to " << tempPath;
+			return;
+		}
+		cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		cacheFile.write(reinterpret_cast<const char*>(offsetArray.data()), offsetArray.size() * sizeof(int32_t));
+		cacheFile.write(reinterpret_cast<const char*>(neighborArray.data()), neighborArray.size() * sizeof(int32_t));
+		cacheFile.write(reinterpret_cast<const char*>(centerArray.data()), centerArray.size() * sizeof(int32_t));
+		cacheFile.write(reinterpret_cast<const char*>(coastalArray.data()), coastalArray.size() * sizeof(int32_t));
+		cacheFile.write(reinterpret_cast<const char*>(positionArray.data()), positionArray.size() * sizeof(int32_t));
+		cacheFile.write(reinterpret_cast<const char*>(flagArray.data()), flagArray.size());
+		if (!cacheFile)
+		{
+			LOG(LogLevel::Debug) << "Could not write the map topology cache to " << tempPath;
+			cacheFile.close();
+			remove(tempPath.c_str());
+			return;
+		}
+	}
+
+	remove(cachePath.c_str());
+	if (rename(tempPath.c_str(), cachePath.c_str()) != 0)
+	{
+		LOG(LogLevel::Debug) << "Could not move the map topology cache into place at " << cachePath;
+		remove(tempPath.c_str());
+	}
+}
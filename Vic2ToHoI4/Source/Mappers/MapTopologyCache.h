@@ -0,0 +1,116 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef MAP_TOPOLOGY_CACHE_H
+#define MAP_TOPOLOGY_CACHE_H
+
+
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include "ProvinceIndexed.h"
+#include "ProvinceNeighborMapper.h"
+#include "OSCompatibilityLayer.h"
+using namespace std;
+
+
+
+// The facts about the HoI4 map that only change along with provinces.bmp, definition.csv or positions.txt: which provinces neighbor each other
+// and where their borders are, which provinces are coastal, and where each province is. Working these out takes a scan of
+// the whole map, so they're saved to cache/HoI4MapTopology.bin and mapped straight back in on later runs against the same map. The mappers
+// that own each of these facts fill themselves from here when the cache is valid.
+class mapTopologyCache
+{
+	public:
+		static bool isValid()
+		{
+			return getInstance()->valid;
+		}
+
+		static void getNeighbors(provinceIndexedLists<int>& neighbors, provinceIndexedLists<point>& borderCenters)
+		{
+			getInstance()->GetNeighbors(neighbors, borderCenters);
+		}
+
+		static map<int, int> getCoastalProvinces()
+		{
+			return getInstance()->GetCoastalProvinces();
+		}
+
+		// Comes from positions.txt if the cache isn't valid
+		static provinceIndexedMap<pair<int, int>> getProvincePositions()
+		{
+			return getInstance()->GetProvincePositions();
+		}
+
+		// Saves what the mappers worked out this run, unless it came from the cache in the first place
+		static void save()
+		{
+			getInstance()->Save();
+		}
+
+	private:
+		static mapTopologyCache* instance;
+		static mapTopologyCache* getInstance()
+		{
+			if (instance == nullptr)
+			{
+				instance = new mapTopologyCache();
+			}
+
+			return instance;
+		}
+		mapTopologyCache();
+
+		struct sourceKey
+		{
+			uint64_t size;	// the size of the source file
+			uint64_t modifiedTime;	// when the source file was last written
+			uint64_t hash;	// the hash of the source file's contents
+		};
+
+		bool checkSource(const string& path, const sourceKey& cachedKey) const;
+		sourceKey makeSourceKey(const string& path) const;
+		provinceIndexedMap<pair<int, int>> readProvincePositions() const;
+
+		void GetNeighbors(provinceIndexedLists<int>& neighbors, provinceIndexedLists<point>& borderCenters) const;
+		map<int, int> GetCoastalProvinces() const;
+		provinceIndexedMap<pair<int, int>> GetProvincePositions() const;
+		void Save();
+
+		bool valid;	// whether the cache matches the current map
+		unique_ptr<Utils::mappedFile> file;	// the cache, which the arrays below point into
+		uint32_t numProvinces;	// one more than the highest province number
+		const int32_t* neighborOffsets;	// where each province's neighbors start in neighbors, with an extra one marking the end
+		const int32_t* neighbors;	// every province's neighbors, in order
+		const int32_t* borderCenters;	// the x and y of the center of each border in neighbors
+		const int32_t* coastalSeas;	// the sea province each coastal province connects to
+		const int32_t* positions;	// the x and y of each province
+		const uint8_t* flags;	// whether each province is coastal or has a position
+};
+
+
+
+#endif // MAP_TOPOLOGY_CACHE_H
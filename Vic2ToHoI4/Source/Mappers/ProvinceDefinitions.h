@@ -26,8 +26,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
-#include <map>
 #include <set>
+#include <unordered_map>
 #include "../Color.h"
 using namespace std;
 
@@ -68,7 +68,7 @@ class provinceDefinitions
 		int getIntFromColor(const Color& color) const;
 
 		set<int> landProvinces;
-		map<int, int> colorToProvinceMap;	// colors are a packed integer to work around some issues. If you can get Colors to work directly, please replace this hack.
+		unordered_map<int, int> colorToProvinceMap;	// colors are a packed integer to work around some issues. If you can get Colors to work directly, please replace this hack.
 };
 
 
@@ -67,6 +67,8 @@ void provinceMapper::initProvinceMap(Object* parsedMappingsFile)
 
 void provinceMapper::processMappings(const vector<Object*>& mappings)
 {
+	map<int, vector<int>> HoI4ToVic2Lists;
+	map<int, vector<int>> Vic2ToHoI4Lists;
 	for (auto mapping: mappings)
 	{
 		vector<int> Vic2Nums;
@@ -97,31 +99,34 @@ void provinceMapper::processMappings(const vector<Object*>& mappings)
 			HoI4Nums.push_back(0);
 		}
 
-		insertIntoHoI4ToVic2ProvinceMap(Vic2Nums, HoI4Nums);
-		insertIntoVic2ToHoI4ProvinceMap(Vic2Nums, HoI4Nums);
+		insertIntoHoI4ToVic2ProvinceMap(Vic2Nums, HoI4Nums, HoI4ToVic2Lists);
+		insertIntoVic2ToHoI4ProvinceMap(Vic2Nums, HoI4Nums, Vic2ToHoI4Lists);
 	}
+
+	HoI4ToVic2ProvinceMap = HoI4ToVic2ProvinceMapping(HoI4ToVic2Lists);
+	Vic2ToHoI4ProvinceMap = Vic2ToHoI4ProvinceMapping(Vic2ToHoI4Lists);
 }
 
 
-void provinceMapper::insertIntoHoI4ToVic2ProvinceMap(const vector<int>& Vic2Nums, const vector<int>& HoI4Nums)
+void provinceMapper::insertIntoHoI4ToVic2ProvinceMap(const vector<int>& Vic2Nums, const vector<int>& HoI4Nums, map<int, vector<int>>& HoI4ToVic2Lists)
 {
 	for (auto num: HoI4Nums)
 	{
 		if (num != 0)
 		{
-			HoI4ToVic2ProvinceMap.insert(make_pair(num, Vic2Nums));
+			HoI4ToVic2Lists.insert(make_pair(num, Vic2Nums));
 		}
 	}
 }
 
 
-void provinceMapper::insertIntoVic2ToHoI4ProvinceMap(const vector<int>& Vic2Nums, const vector<int>& HoI4Nums)
+void provinceMapper::insertIntoVic2ToHoI4ProvinceMap(const vector<int>& Vic2Nums, const vector<int>& HoI4Nums, map<int, vector<int>>& Vic2ToHoI4Lists)
 {
 	for (auto num: Vic2Nums)
 	{
 		if (num != 0)
 		{
-			Vic2ToHoI4ProvinceMap.insert(make_pair(num, HoI4Nums));
+			Vic2ToHoI4Lists.insert(make_pair(num, HoI4Nums));
 		}
 	}
 }
@@ -207,6 +212,6 @@ vector<int> provinceMapper::getHoI4ProvinceNums(const int v2ProvinceNum)
 	}
 	else
 	{
-		return itr->second;
+		return vector<int>(itr->second.begin(), itr->second.end());
 	}
 }
\ No newline at end of file
@@ -29,6 +29,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <map>
 #include <unordered_set>
 #include <vector>
+#include "ProvinceIndexed.h"
 using namespace std;
 
 
@@ -37,8 +38,8 @@ class Object;
 
 
 
-typedef map< int, vector<int> > HoI4ToVic2ProvinceMapping;
-typedef map< int, vector<int> > Vic2ToHoI4ProvinceMapping;
+typedef provinceIndexedLists<int> HoI4ToVic2ProvinceMapping;
+typedef provinceIndexedLists<int> Vic2ToHoI4ProvinceMapping;
 
 
 
@@ -73,8 +74,8 @@ class provinceMapper
 		vector<Object*> getCorrectMappingVersion(const vector<Object*>& versions);
 		void processMappings(const vector<Object*>& mappings);
 		vector<int> getHoI4ProvinceNums(int v2ProvinceNum);
-		void insertIntoHoI4ToVic2ProvinceMap(const vector<int>& Vic2Nums, const vector<int>& HoI4nums);
-		void insertIntoVic2ToHoI4ProvinceMap(const vector<int>& Vic2Nums, const vector<int>& HoI4nums);
+		void insertIntoHoI4ToVic2ProvinceMap(const vector<int>& Vic2Nums, const vector<int>& HoI4nums, map<int, vector<int>>& HoI4ToVic2Lists);
+		void insertIntoVic2ToHoI4ProvinceMap(const vector<int>& Vic2Nums, const vector<int>& HoI4nums, map<int, vector<int>>& Vic2ToHoI4Lists);
 
 		void checkAllHoI4ProvinesMapped();
 		int getNextProvinceNumFromFile(ifstream& definitions);
@@ -22,10 +22,18 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 #include "ProvinceNeighborMapper.h"
+#include "MapTopologyCache.h"
 #include "provinceDefinitions.h"
 #include "../Color.h"
 #include "../Configuration.h"
 #include "log.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PROVINCE_NEIGHBOR_MAPPER_SSE2
+#include <emmintrin.h>
+#endif
 
 
 
@@ -33,216 +41,265 @@ provinceNeighborMapper* provinceNeighborMapper::instance = nullptr;
 
 
 
-provinceNeighborMapper::provinceNeighborMapper()
+// Each distinct color on the map is given a small index, so that the map can be held as one uint16_t per pixel
+static const uint16_t noColorIndex = 0xFFFF;
+
+// Rows are split into this many bands per thread, so that a thread with an easy band can take on another
+static const unsigned int bandsPerThread = 4;
+
+
+static void addPointToBorder(int mainProvince, int neighborProvince, point position, bordersByProvince& borders)
 {
-	bitmap_image provinces(Configuration::getHoI4Path() + "/map/provinces.bmp");
-	if (!provinces)
+	auto& neighbors = borders[mainProvince];	// the borders of the main province found so far
+	auto border = neighbors.rbegin();
+	while ((border != neighbors.rend()) && (border->neighbor != neighborProvince))
 	{
-		LOG(LogLevel::Error) << "Could not open " << Configuration::getHoI4Path() << "/map/provinces.bmp";
+		++border;
+	}
+	if (border == neighbors.rend())
+	{
+		neighborBorder newBorder = { neighborProvince, {} };
+		neighbors.push_back(newBorder);
+		border = neighbors.rbegin();
 	}
 
-	unsigned int height = provinces.height();
-	unsigned int width = provinces.width();
+	if (border->points.empty() || (border->points.back() != position))
+	{
+		border->points.push_back(position);
+	}
+}
 
-	for (unsigned int y = 0; y < height; y++)
+
+// Compares every pixel in [x, x + 8) with the ones around it, returning true if none of them are on a border
+static bool isInsideProvince(const uint16_t* above, const uint16_t* center, const uint16_t* below, unsigned int x)
+{
+#ifdef PROVINCE_NEIGHBOR_MAPPER_SSE2
+	__m128i centerColors = _mm_loadu_si128(reinterpret_cast<const __m128i*>(center + x));
+	__m128i same = _mm_and_si128(
+		_mm_cmpeq_epi16(centerColors, _mm_loadu_si128(reinterpret_cast<const __m128i*>(above + x))),
+		_mm_cmpeq_epi16(centerColors, _mm_loadu_si128(reinterpret_cast<const __m128i*>(below + x)))
+	);
+	same = _mm_and_si128(same, _mm_cmpeq_epi16(centerColors, _mm_loadu_si128(reinterpret_cast<const __m128i*>(center + x - 1))));
+	same = _mm_and_si128(same, _mm_cmpeq_epi16(centerColors, _mm_loadu_si128(reinterpret_cast<const __m128i*>(center + x + 1))));
+	return (_mm_movemask_epi8(same) == 0xFFFF);
+#else
+	for (unsigned int i = x; i < x + 8; i++)
 	{
-		for (unsigned int x = 0; x < width; x++)
+		if ((center[i] != above[i]) || (center[i] != below[i]) || (center[i] != center[i - 1]) || (center[i] != center[i + 1]))
 		{
-			point position = { x, y };
+			return false;
+		}
+	}
+	return true;
+#endif
+}
+
 
-			Color centerColor = getCenterColor(provinces, position);
-			Color aboveColor = getAboveColor(provinces, position, height);
-			Color belowColor = getBelowColor(provinces, position, height);
-			Color leftColor = getLeftColor(provinces, position, width);
-			Color rightColor = getRightColor(provinces, position, width);
+// Finds the borders in rows [firstRow, lastRow). The map wraps around from left to right, but not from top to bottom.
+static void findBordersInRows(const vector<uint16_t>& raster, unsigned int width, unsigned int height, unsigned int firstRow, unsigned int lastRow, const vector<int>& colorProvinces, bordersByProvince& borders)
+{
+	for (unsigned int y = firstRow; y < lastRow; y++)
+	{
+		const uint16_t* center = &raster[static_cast<size_t>(y) * width];
+		const uint16_t* above = (y > 0) ? center - width : center;
+		const uint16_t* below = (y < height - 1) ? center + width : center;
+		int flippedY = height - y - 1;	// the row counted from the bottom, as HoI4 does
 
-			position.second = height - position.second - 1;
-			if (centerColor != aboveColor)
+		auto checkPixel = [&](unsigned int x)
+		{
+			uint16_t color = center[x];
+			uint16_t neighbors[4] =
 			{
-				handleNeighbor(centerColor, aboveColor, position);
-			}
-			if (centerColor != rightColor)
+				above[x],
+				center[(x < width - 1) ? x + 1 : 0],
+				below[x],
+				center[(x > 0) ? x - 1 : width - 1]
+			};
+			for (auto neighbor: neighbors)
 			{
-				handleNeighbor(centerColor, rightColor, position);
+				if (neighbor != color)
+				{
+					addPointToBorder(colorProvinces[color], colorProvinces[neighbor], make_pair(static_cast<int>(x), flippedY), borders);
+				}
 			}
-			if (centerColor != belowColor)
+		};
+
+		unsigned int x = 0;
+		while (x < width)
+		{
+			// the first and last pixels wrap around, so only whole blocks in between are checked together
+			if ((x > 0) && (x + 8 < width))
 			{
-				handleNeighbor(centerColor, belowColor, position);
+				if (!isInsideProvince(above, center, below, x))
+				{
+					for (unsigned int i = x; i < x + 8; i++)
+					{
+						checkPixel(i);
+					}
+				}
+				x += 8;
 			}
-			if (centerColor != leftColor)
+			else
 			{
-				handleNeighbor(centerColor, leftColor, position);
+				checkPixel(x);
+				x++;
 			}
 		}
 	}
 }
 
 
-Color provinceNeighborMapper::getCenterColor(bitmap_image& provinces, point position)
-{
-	rgb_t color;
-	provinces.get_pixel(position.first, position.second, color);
-
-	Color theColor(color.red, color.green, color.blue);
-	return theColor;
-}
-
-
-Color provinceNeighborMapper::getAboveColor(bitmap_image& provinces, point position, int height)
+provinceNeighborMapper::provinceNeighborMapper()
 {
-	if (position.second > 0)
+	if (mapTopologyCache::isValid())
 	{
-		position.second--;
+		mapTopologyCache::getNeighbors(provinceNeighbors, borderCenters);
+		return;
 	}
 
-	rgb_t color;
-	provinces.get_pixel(position.first, position.second, color);
-
-	Color theColor(color.red, color.green, color.blue);
-	return theColor;
-}
-
-
-Color provinceNeighborMapper::getBelowColor(bitmap_image& provinces, point position, int height)
-{
-	if (position.second < height - 1)
+	bitmap_image provinces(Configuration::getHoI4Path() + "/map/provinces.bmp");
+	if (!provinces)
 	{
-		position.second++;
+		LOG(LogLevel::Error) << "Could not open " << Configuration::getHoI4Path() << "/map/provinces.bmp";
 	}
 
-	rgb_t color;
-	provinces.get_pixel(position.first, position.second, color);
-
-	Color theColor(color.red, color.green, color.blue);
-	return theColor;
-}
+	unsigned int height = provinces.height();
+	unsigned int width = provinces.width();
 
+	vector<uint16_t> raster;		// the color index of every pixel
+	vector<int> colorProvinces;	// the province for each color index
+	readProvinceRaster(provinces, raster, colorProvinces);
 
-Color provinceNeighborMapper::getLeftColor(bitmap_image& provinces, point position, int width)
-{
-	if (position.first > 0)
+	size_t numProvinces = 1;	// one more than the highest province number on the map
+	for (auto province: colorProvinces)
 	{
-		position.first--;
+		numProvinces = max(numProvinces, static_cast<size_t>(province) + 1);
 	}
-	else
-	{
-		position.first = width - 1;
-	}
-
-	rgb_t color;
-	provinces.get_pixel(position.first, position.second, color);
-
-	Color theColor(color.red, color.green, color.blue);
-	return theColor;
-}
-
 
-Color provinceNeighborMapper::getRightColor(bitmap_image& provinces, point position, int width)
-{
-	if (position.first < width - 1)
+	// the bands of rows are scanned in parallel, each into its own borders, and then merged in order
+	unsigned int numThreads = max(1u, thread::hardware_concurrency());	// the number of threads to scan with
+	unsigned int numBands = min(height, numThreads * bandsPerThread);		// the number of bands the rows are split into
+	vector<bordersByProvince> bands(numBands);
+	atomic<unsigned int> nextBand(0);	// the first band no thread has started on
+	auto work = [&]()
+	{
+		for (unsigned int band = nextBand++; band < numBands; band = nextBand++)
+		{
+			bands[band].resize(numProvinces);
+			findBordersInRows(raster, width, height, height * band / numBands, height * (band + 1) / numBands, colorProvinces, bands[band]);
+		}
+	};
+	vector<thread> workers;	// the extra threads
+	for (unsigned int i = 1; i < numThreads; i++)
 	{
-		position.first++;
+		workers.push_back(thread(work));
 	}
-	else
+	work();
+	for (auto& worker: workers)
 	{
-		position.first = 0;
+		worker.join();
 	}
 
-	rgb_t color;
-	provinces.get_pixel(position.first, position.second, color);
-
-	Color theColor(color.red, color.green, color.blue);
-	return theColor;
+	storeBorders(bands);
 }
 
 
-void provinceNeighborMapper::handleNeighbor(Color centerColor, Color otherColor, point position)
+// Converts the bitmap into a raster of color indexes, looking up each color's province only once
+void provinceNeighborMapper::readProvinceRaster(bitmap_image& provinces, vector<uint16_t>& raster, vector<int>& colorProvinces)
 {
-	int centerProvince = provinceDefinitions::getProvinceFromColor(centerColor);
-	int otherProvince = provinceDefinitions::getProvinceFromColor(otherColor);
-
-	addNeighbor(centerProvince, otherProvince);
-	addPointToBorder(centerProvince, otherProvince, position);
-}
-
+	unsigned int height = provinces.height();
+	unsigned int width = provinces.width();
+	unsigned int bytesPerPixel = provinces.bytes_per_pixel();
 
-void provinceNeighborMapper::addNeighbor(int mainProvince, int neighborProvince)
-{
-	auto centerMapping = provinceNeighbors.find(mainProvince);
-	if (centerMapping != provinceNeighbors.end())
-	{
-		centerMapping->second.insert(neighborProvince);
-	}
-	else
+	vector<uint16_t> colorIndexes(1 << 24, noColorIndex);	// the index of every 24-bit color seen so far
+	raster.resize(static_cast<size_t>(width) * height);
+	for (unsigned int y = 0; y < height; y++)
 	{
-		set<int> neighbors = { neighborProvince };
-		provinceNeighbors[mainProvince] = neighbors;
+		const unsigned char* pixel = provinces.row(y);	// the blue, green and red of the current pixel
+		uint16_t* rasterRow = &raster[static_cast<size_t>(y) * width];
+		for (unsigned int x = 0; x < width; x++, pixel += bytesPerPixel)
+		{
+			unsigned int colorInt = (pixel[2] << 16) | (pixel[1] << 8) | pixel[0];
+			uint16_t& index = colorIndexes[colorInt];
+			if (index == noColorIndex)
+			{
+				if (colorProvinces.size() < noColorIndex)
+				{
+					index = static_cast<uint16_t>(colorProvinces.size());
+					colorProvinces.push_back(provinceDefinitions::getProvinceFromColor(Color(pixel[2], pixel[1], pixel[0])));
+				}
+				else
+				{
+					LOG(LogLevel::Warning) << "provinces.bmp has too many colors, so " << Color(pixel[2], pixel[1], pixel[0]) << " is treated as the same as another";
+					index = noColorIndex - 1;
+				}
+			}
+			rasterRow[x] = index;
+		}
 	}
 }
 
 
-void provinceNeighborMapper::addPointToBorder(int mainProvince, int neighborProvince, point position)
+// Merges the borders found in each band, in order, so that the points along each border are in the same order as a single scan would give.
+// Only the center of each border is kept, as that's the only point of it anything uses.
+void provinceNeighborMapper::storeBorders(vector<bordersByProvince>& bands)
 {
-	auto bordersWithNeighbors = borders.find(mainProvince);
-	if (bordersWithNeighbors == borders.end())
-	{
-		bordersWith newBordersWithNeighbors;
-		borders.insert(make_pair(mainProvince, newBordersWithNeighbors));
-		bordersWithNeighbors = borders.find(mainProvince);
-	}
-
-	auto border = bordersWithNeighbors->second.find(neighborProvince);
-	if (border == bordersWithNeighbors->second.end())
+	size_t numProvinces = bands.empty() ? 0 : bands[0].size();
+	for (size_t province = 0; province < numProvinces; province++)
 	{
-		borderPoints newBorder;
-		bordersWithNeighbors->second.insert(make_pair(neighborProvince, newBorder));
-		border = bordersWithNeighbors->second.find(neighborProvince);
-	}
-
-	if (border->second.size() == 0)
-	{
-		border->second.push_back(position);
-	}
-	else
-	{
-		auto lastPoint = border->second.back();
-		if ((lastPoint.first != position.first) || (lastPoint.second != position.second))
+		vector<neighborBorder> merged;	// all the borders of this province
+		for (auto& band: bands)
+		{
+			for (auto& border: band[province])
+			{
+				auto mergedBorder = merged.begin();
+				while ((mergedBorder != merged.end()) && (mergedBorder->neighbor != border.neighbor))
+				{
+					++mergedBorder;
+				}
+				if (mergedBorder == merged.end())
+				{
+					merged.push_back(move(border));
+				}
+				else
+				{
+					mergedBorder->points.insert(mergedBorder->points.end(), border.points.begin(), border.points.end());
+				}
+			}
+		}
+		if (merged.empty())
 		{
-			border->second.push_back(position);
+			continue;
 		}
-	}
-}
-
 
-const set<int> provinceNeighborMapper::GetNeighbors(int province)
-{
-	auto neighbors = provinceNeighbors.find(province);
-	if (neighbors != provinceNeighbors.end())
-	{
-		return neighbors->second;
-	}
-	else
-	{
-		set<int> empty;
-		return empty;
+		sort(merged.begin(), merged.end(), [](const neighborBorder& a, const neighborBorder& b) { return a.neighbor < b.neighbor; });
+		vector<int> neighbors;
+		vector<point> centers;
+		for (auto& border: merged)
+		{
+			neighbors.push_back(border.neighbor);
+			centers.push_back(border.points[(border.points.size() / 2)]);
+		}
+		provinceNeighbors.append(province, neighbors.begin(), neighbors.end());
+		borderCenters.append(province, centers.begin(), centers.end());
 	}
 }
 
 
 const point provinceNeighborMapper::GetBorderCenter(int mainProvince, int neighbor)
 {
-	auto bordersWithNeighbors = borders.find(mainProvince);
-	if (bordersWithNeighbors == borders.end())
+	if (borderCenters.find(mainProvince) == borderCenters.end())
 	{
 		LOG(LogLevel::Warning) << "Province " << mainProvince << " has no borders.";
 		return make_pair(-1, -1);
 	}
-	auto border = bordersWithNeighbors->second.find(neighbor);
-	if (border == bordersWithNeighbors->second.end())
+	auto neighbors = provinceNeighbors.get(mainProvince);
+	auto border = lower_bound(neighbors.begin(), neighbors.end(), neighbor);
+	if ((border == neighbors.end()) || (*border != neighbor))
 	{
 		LOG(LogLevel::Warning) << "Province " << mainProvince << " does not border " << neighbor << ".";
 		return make_pair(-1, -1);
 	}
 
-	return border->second[(border->second.size() / 2)];
+	return borderCenters.get(mainProvince)[border - neighbors.begin()];
 }
\ No newline at end of file
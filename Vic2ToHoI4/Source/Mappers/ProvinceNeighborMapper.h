@@ -28,24 +28,33 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include <map>
 #include <set>
+#include <stdint.h>
+#include <vector>
 #include "../bitmap_image.hpp"
 #include "../Color.h"
+#include "ProvinceIndexed.h"
 using namespace std;
 
 
 
 typedef pair<int, int> point;
 typedef vector<point> borderPoints;
-typedef map<int, borderPoints> bordersWith;
+
+struct neighborBorder
+{
+	int neighbor;			// the neighboring province
+	borderPoints points;	// the points along the border, in the order they were found
+};
+typedef vector<vector<neighborBorder>> bordersByProvince;	// the borders of each province, indexed by province number
 
 
 
 class provinceNeighborMapper
 {
 	public:
-		static const set<int> getNeighbors(int province)
+		static provinceIndexedLists<int>::list getNeighbors(int province)
 		{
-			return getInstance()->GetNeighbors(province);
+			return getInstance()->provinceNeighbors.get(province);
 		}
 
 		static const point getBorderCenter(int mainProvince, int neighbor)
@@ -53,6 +62,11 @@ class provinceNeighborMapper
 			return getInstance()->GetBorderCenter(mainProvince, neighbor);
 		}
 
+		static const provinceIndexedLists<int>& getAllNeighbors()
+		{
+			return getInstance()->provinceNeighbors;
+		}
+
 	private:
 		static provinceNeighborMapper* instance;
 		static provinceNeighborMapper* getInstance()
@@ -66,20 +80,13 @@ class provinceNeighborMapper
 		}
 		provinceNeighborMapper();
 
-		Color getCenterColor(bitmap_image& provinces, point position);
-		Color getAboveColor(bitmap_image& provinces, point position, int height);
-		Color getBelowColor(bitmap_image& provinces, point position, int height);
-		Color getLeftColor(bitmap_image& provinces, point position, int width);
-		Color getRightColor(bitmap_image& provinces, point position, int width);
-		void handleNeighbor(Color centerColor, Color otherColor, point position);
-		void addNeighbor(int mainProvince, int neighborProvince);
-		void addPointToBorder(int mainProvince, int neighborProvince, point position);
+		void readProvinceRaster(bitmap_image& provinces, vector<uint16_t>& raster, vector<int>& colorProvinces);
+		void storeBorders(vector<bordersByProvince>& bands);
 
-		const set<int> GetNeighbors(int province);
 		const point GetBorderCenter(int mainProvince, int neighbor);
 
-		map<int, set<int>> provinceNeighbors;
-		map<int, bordersWith> borders;
+		provinceIndexedLists<int> provinceNeighbors;	// the neighbors of each province, in increasing order
+		provinceIndexedLists<point> borderCenters;		// the center of each province's border with each of its neighbors, in the same order
 };
 
 
@@ -22,15 +22,17 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 #include "V2Localisations.h"
-#include <fstream>
+#include <cstring>
 #include "../Configuration.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
 #include "Object.h"
+#include "ParallelFor.h"
 
 
 
 V2Localisations* V2Localisations::instance = NULL;
+unordered_set<string> V2Localisations::requiredKeys;
 
 
 
@@ -48,52 +50,108 @@ V2Localisations::V2Localisations()
 }
 
 
+const string languages[] = { "english", "french", "german", "", "spanish" };
 void V2Localisations::ReadFromAllFilesInFolder(const string& folderPath)
 {
 	set<string> fileNames;
 	Utils::GetAllFilesInFolder(folderPath, fileNames);
-
+	vector<string> filePaths;
 	for (const auto& fileName: fileNames)
 	{
-		ReadFromFile(folderPath + '/' + fileName);
+		filePaths.push_back(folderPath + '/' + fileName);
+	}
+
+	vector<FileLocalisations> fileLocalisations(filePaths.size());
+	Utils::parallelFor(filePaths.size(), [&](size_t i)
+	{
+		fileLocalisations[i] = ReadFromFile(filePaths[i]);
+	});
+
+	// later files replace the localisations from earlier ones, so they're added in order
+	for (const auto& localisationsInFile: fileLocalisations)
+	{
+		for (const auto& keyLocalisations: localisationsInFile)
+		{
+			auto& languageToLocalisation = localisations[keyLocalisations.first];
+			for (unsigned int i = 0; i < keyLocalisations.second.size(); i++)
+			{
+				languageToLocalisation[languages[i]] = keyLocalisations.second[i];
+			}
+		}
 	}
 }
 
 
-void V2Localisations::ReadFromFile(const string& fileName)
+V2Localisations::FileLocalisations V2Localisations::ReadFromFile(const string& fileName) const
 {
-	ifstream in(fileName);
+	FileLocalisations fileLocalisations;
 
-	while (!in.eof())
+	Utils::mappedFile file(fileName);
+	if (!file.isOpen())
 	{
-		string line;
-		getline(in, line);
-		if (line[0] != '#')
+		return fileLocalisations;
+	}
+
+	const char* lineBegin = file.begin();
+	const char* end = file.end();
+	while (true)
+	{
+		const char* lineEnd = static_cast<const char*>(memchr(lineBegin, '\n', end - lineBegin));
+		const char* textEnd = (lineEnd != nullptr) ? lineEnd : end;
+		if ((textEnd != lineBegin) && (*(textEnd - 1) == '\r'))
+		{
+			textEnd--;
+		}
+
+		if (((textEnd == lineBegin) || (*lineBegin != '#')) && isRequiredKey(lineBegin, textEnd))
+		{
+			processLine(string(lineBegin, textEnd), fileLocalisations);
+		}
+
+		if (lineEnd == nullptr)
 		{
-			processLine(line);
+			break;
 		}
+		lineBegin = lineEnd + 1;
 	}
 
-	in.close();
+	return fileLocalisations;
 }
 
 
-const string languages[] = { "english", "french", "german", "", "spanish" };
-void V2Localisations::processLine(string line)
+bool V2Localisations::isRequiredKey(const char* lineBegin, const char* lineEnd) const
+{
+	if (requiredKeys.empty())
+	{
+		return true;
+	}
+
+	const char* keyEnd = static_cast<const char*>(memchr(lineBegin, ';', lineEnd - lineBegin));
+	if (keyEnd == nullptr)
+	{
+		keyEnd = lineEnd;
+	}
+	return (requiredKeys.count(string(lineBegin, keyEnd)) > 0);
+}
+
+
+void V2Localisations::processLine(string line, FileLocalisations& fileLocalisations) const
 {
 	int division = line.find_first_of(';');
 	string key = line.substr(0, division);
 
-	for (auto language: languages)
+	vector<string> localisationsInLanguages;
+	for (unsigned int i = 0; i < sizeof(languages) / sizeof(languages[0]); i++)
 	{
 		string result = getNextLocalisation(line, division);
 		result = replaceBadCharacters(result);
-		localisations[key][language] = Utils::convert8859_15ToUTF8(result);
+		localisationsInLanguages.push_back(Utils::convert8859_15ToUTF8(result));
 	}
+	fileLocalisations.push_back(make_pair(key, localisationsInLanguages));
 }
 
 
-string V2Localisations::getNextLocalisation(string line, int& division)
+string V2Localisations::getNextLocalisation(string line, int& division) const
 {
 	int frontDivision = division + 1;
 	division = line.find_first_of(';', frontDivision);
@@ -101,7 +159,7 @@ string V2Localisations::getNextLocalisation(string line, int& division)
 }
 
 
-string V2Localisations::replaceBadCharacters(string localisation)
+string V2Localisations::replaceBadCharacters(string localisation) const
 {
 	//  gets translated to an invalid character sequence. :-(
 	int O = localisation.find_first_of('');
@@ -29,6 +29,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 using namespace std;
 
 
@@ -36,6 +39,12 @@ using namespace std;
 class V2Localisations
 {
 	public:
+		// only these keys are read, so every key that will be looked up must be added before the first lookup
+		static void addRequiredKey(const string& key)
+		{
+			requiredKeys.insert(key);
+		}
+
 		static const string GetTextInLanguage(const string& key, const string& language)
 		{
 			return getInstance()->ActuallyGetTextInLanguage(key, language);
@@ -47,6 +56,7 @@ class V2Localisations
 
 	private:
 		static V2Localisations* instance;
+		static unordered_set<string> requiredKeys;
 		static V2Localisations* getInstance()
 		{
 			if (instance == NULL)
@@ -57,11 +67,14 @@ class V2Localisations
 		}
 
 		V2Localisations();
+		typedef vector<pair<string, vector<string>>> FileLocalisations;	// keys and their text in each language, in file order
+
 		void ReadFromAllFilesInFolder(const string& folderPath);
-		void ReadFromFile(const string& fileName);
-		void processLine(string line);
-		string getNextLocalisation(string line, int& division);
-		string replaceBadCharacters(string localisation);
+		FileLocalisations ReadFromFile(const string& fileName) const;
+		bool isRequiredKey(const char* lineBegin, const char* lineEnd) const;
+		void processLine(string line, FileLocalisations& fileLocalisations) const;
+		string getNextLocalisation(string line, int& division) const;
+		string replaceBadCharacters(string localisation) const;
 
 		const string ActuallyGetTextInLanguage(const string& key, const string& language) const;
 		const map<string, string>& ActuallyGetTextInEachLanguage(const string& key) const;
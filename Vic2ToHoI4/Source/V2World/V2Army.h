@@ -63,7 +63,7 @@ class V2Army // also Navy
 		double getSupplies() const { return supplies; }
 		int isAtSea() const { return at_sea; }
 		int getLocation() const { return location; }
-		vector<V2Regiment*> getRegiments() const { return regiments; }
+		const vector<V2Regiment*>& getRegiments() const { return regiments; }
 
 	private:
 		string name;
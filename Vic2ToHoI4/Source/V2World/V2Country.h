@@ -62,25 +62,25 @@ class V2Country
 		void setLocalisationNames();
 		void setLocalisationAdjectives();
 
-		map<string, V2Relations*> getRelations() const { return relations; }
-		vector<Vic2State*> getStates() const { return states; }
+		const map<string, V2Relations*>& getRelations() const { return relations; }
+		const vector<Vic2State*>& getStates() const { return states; }
 		string getTag() const { return tag; }
 		string getPrimaryCulture() const { return primaryCulture; }
-		set<string> getInventions() const { return inventions; }
+		const set<string>& getInventions() const { return inventions; }
 		string getGovernment() const { return government; }
 		int getCapital() const { return capital; }
-		vector<string> getTechs() const { return techs; }
+		const vector<string>& getTechs() const { return techs; }
 		Color getColor() const { return color; }
 		double getEducationSpending() const { return educationSpending; }
 		double getMilitarySpending() const { return militarySpending; }
-		vector<V2Army*> getArmies() const { return armies; }
-		vector<V2Leader*> getLeaders() const { return leaders; }
+		const vector<V2Army*>& getArmies() const { return armies; }
+		const vector<V2Leader*>& getLeaders() const { return leaders; }
 		double getRevanchism() const { return revanchism; }
 		double getWarExhaustion() const { return warExhaustion; }
-		map<string, string> getAllReforms() const { return reformsArray; }
+		const map<string, string>& getAllReforms() const { return reformsArray; }
 		bool isGreatNation() const { return greatNation; }
-		map<string, string> getLocalisedNames() const { return namesByLanguage; }
-		map<string, string> getLocalisedAdjectives() const { return adjectivesByLanguage; }
+		const map<string, string>& getLocalisedNames() const { return namesByLanguage; }
+		const map<string, string>& getLocalisedAdjectives() const { return adjectivesByLanguage; }
 
 		bool isEmpty() const { return ((cores.size() == 0) && (provinces.size() == 0)); }
 
@@ -53,7 +53,7 @@ class V2Province
 		int getNumber() const { return number; }
 		string getOwnerString() const { return ownerString; }
 		const V2Country* getOwner() const { return owner; }
-		set<V2Country*> getCores() const { return cores; }
+		const set<V2Country*>& getCores() const { return cores; }
 		int getRailLevel() const { return railLevel; }
 		int getFortLevel() const { return fortLevel; }
 		int getNavalBaseLevel() const { return navalBaseLevel; }
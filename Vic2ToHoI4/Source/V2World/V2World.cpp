@@ -25,6 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <fstream>
 #include "ParadoxParser8859_15.h"
 #include "ParadoxParserUTF8.h"
+#include "ParadoxParserVisitor.h"
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
 #include "V2Country.h"
@@ -34,6 +35,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "Vic2State.h"
 #include "../Mappers/CountryMapping.h"
 #include "../Mappers/ProvinceMapper.h"
+#include "../Mappers/V2Localisations.h"
 
 
 
@@ -42,7 +44,7 @@ V2World::V2World(const string& filename)
 	LOG(LogLevel::Info) << "* Importing V2 save *";
 
 	LOG(LogLevel::Info) << "Parsing save";
-	Object* obj = parser_8859_15::doParseFile(filename);
+	Object* obj = parser_8859_15::doParseFile(filename, parser_core::parseMode::lazy);
 	if (obj == NULL)
 	{
 		LOG(LogLevel::Error) << "Could not parse file " << filename << ". File is likely missing.";
@@ -59,8 +61,8 @@ V2World::V2World(const string& filename)
 	map<int, int> countryIndexToGPRank = extractGreatNationIndices(obj);
 	unsigned int countryIndex = 1; // Starts from 1 at REB
 
-	vector<Object*> leaves = obj->getLeaves();
-	for (auto leaf: leaves)
+	// provinces and countries are read from the save one at a time, and each one's objects are released once it has been built
+	parser_core::childStreamer saveHandler([&](Object* leaf)
 	{
 		string key = leaf->getKey();
 
@@ -74,7 +76,8 @@ V2World::V2World(const string& filename)
 			setGreatPowerStatus(key, countryIndexToGPRank, countryIndex);
 			countryIndex++;
 		}
-	}
+	});
+	parser_core::visitContents(obj, saveHandler);
 
 	setProvinceOwners();
 	addProvinceCoreInfoToCountries();
@@ -450,6 +453,8 @@ V2Country* V2World::getCountry(string tag) const
 
 void V2World::setLocalisations()
 {
+	addRequiredLocalisationKeys();
+
 	for (auto country: countries)
 	{
 		country.second->setLocalisationNames();
@@ -458,6 +463,29 @@ void V2World::setLocalisations()
 }
 
 
+void V2World::addRequiredLocalisationKeys() const
+{
+	// country names and adjectives, state names, party names, and province names are the only localisations the converter uses
+	for (auto country: countries)
+	{
+		V2Localisations::addRequiredKey(country.first);
+		V2Localisations::addRequiredKey(country.first + "_ADJ");
+		for (auto state: country.second->getStates())
+		{
+			V2Localisations::addRequiredKey(state->getStateID());
+		}
+	}
+	for (auto party: parties)
+	{
+		V2Localisations::addRequiredKey(party->name);
+	}
+	for (auto province: provinces)
+	{
+		V2Localisations::addRequiredKey("PROV" + to_string(province.first));
+	}
+}
+
+
 const V2Province* V2World::getProvince(int provNum) const
 {
 	auto provinceItr = provinces.find(provNum);
@@ -467,7 +495,7 @@ const V2Province* V2World::getProvince(int provNum) const
 
 void V2World::checkAllProvincesMapped() const
 {
-	auto Vic2ToHoI4ProvinceMapping = provinceMapper::getVic2ToHoI4ProvinceMapping();
+	auto& Vic2ToHoI4ProvinceMapping = provinceMapper::getVic2ToHoI4ProvinceMapping();
 	for (auto province: provinces)
 	{
 		if (Vic2ToHoI4ProvinceMapping.find(province.first) == Vic2ToHoI4ProvinceMapping.end())
@@ -54,6 +54,7 @@ class V2World
 
 	private:
 		void setLocalisations();
+		void addRequiredLocalisationKeys() const;
 
 		map<int, int> extractGreatNationIndices(const Object* obj);
 
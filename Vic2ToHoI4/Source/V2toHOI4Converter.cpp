@@ -27,14 +27,18 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "Flags.h"
 #include "Log.h"
 #include "HoI4World/HoI4World.h"
+#include "Mappers/MapTopologyCache.h"
 #include "V2World/V2World.h"
 #include "OSCompatibilityLayer.h"
+#include "ParsedFileCache.h"
 
 
 
 void ConvertV2ToHoI4(const string& V2SaveFileName);
 int main(const int argc, const char* argv[])
 {
+	Log::flushOnCrash();
+
 	try
 	{
 		LOG(LogLevel::Info) << "Converter version 0.1C";
@@ -76,11 +80,13 @@ void ConvertV2ToHoI4(const string& V2SaveFileName)
 
 	checkMods();
 	getOutputName(V2SaveFileName);
+	parser_cache::enable(Utils::getCurrentDirectory() + "/cache");
 
 	V2World sourceWorld(V2SaveFileName);
 	HoI4World destWorld(&sourceWorld);
 
 	output(destWorld);
+	mapTopologyCache::save();
 	LOG(LogLevel::Info) << "* Conversion complete *";
 }
 
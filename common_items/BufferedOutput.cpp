@@ -0,0 +1,257 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#include "BufferedOutput.h"
+#include "Log.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+
+
+namespace buffered_output
+{
+	static const unsigned int maxWriters = 4;	// the most threads writing at once, as more than a few only contend for the disk
+	static const size_t maxQueuedBytes = 64 * 1024 * 1024;	// how much may wait to be written before queueing more waits for it
+
+
+	// A file waiting to be written
+	struct pendingFile
+	{
+		std::string filename;	// where the file goes
+		std::string contents;	// everything in the file
+	};
+
+
+	// Writes queued files on a few threads, which are started by the first write and stopped again by finish(). Each file name always goes
+	// to the same writer, which writes its files in the order they were queued, so the last write to a file is the one that's kept.
+	class writerPool
+	{
+		public:
+			static writerPool& get()
+			{
+				static writerPool* pool = new writerPool();	// never deleted, so that it outlives anything writing during shutdown
+				return *pool;
+			}
+
+			void write(const std::string& filename, std::string&& contents)
+			{
+				std::unique_lock<std::mutex> lock(queueMutex);
+				queueChanged.wait(lock, [this]() { return (queuedFiles == 0) || (queuedBytes < maxQueuedBytes); });
+
+				if (writers.empty())
+				{
+					startTime = std::chrono::steady_clock::now();
+					unsigned int numWriters = std::max(1u, std::min(maxWriters, std::thread::hardware_concurrency()));
+					queues.resize(numWriters);
+					for (unsigned int i = 0; i < numWriters; i++)
+					{
+						writers.push_back(std::thread(&writerPool::run, this, i));
+					}
+				}
+
+				queuedBytes += contents.size();
+				queuedFiles++;
+				queues[std::hash<std::string>()(filename) % queues.size()].push_back(pendingFile{ filename, std::move(contents) });
+				queueChanged.notify_all();
+			}
+
+			bool finish()
+			{
+				std::unique_lock<std::mutex> lock(queueMutex);
+				queueChanged.wait(lock, [this]() { return (queuedFiles == 0) && (filesInProgress == 0); });
+				if (writers.empty())
+				{
+					return true;
+				}
+
+				stopping = true;
+				queueChanged.notify_all();
+				std::vector<std::thread> finishedWriters;
+				finishedWriters.swap(writers);
+				lock.unlock();
+				for (auto& writer: finishedWriters)
+				{
+					writer.join();
+				}
+				lock.lock();
+				stopping = false;
+				queues.clear();
+
+				double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+				double megabytes = bytesWritten / (1024.0 * 1024.0);
+				LOG(LogLevel::Info) << "Wrote " << filesWritten << " files (" << megabytes << " MB) in " << seconds << " seconds: "
+					<< filesWritten / std::max(seconds, 0.001) << " files and " << megabytes / std::max(seconds, 0.001) << " MB per second";
+
+				bool succeeded = !failed;
+				filesWritten = 0;
+				bytesWritten = 0;
+				failed = false;
+				return succeeded;
+			}
+
+		private:
+			writerPool(): queueMutex(), queueChanged(), queues(), queuedFiles(0), queuedBytes(0), filesInProgress(0), stopping(false), writers(), startTime(), filesWritten(0), bytesWritten(0), failed(false) {}
+
+			void run(unsigned int writer)
+			{
+				std::unique_lock<std::mutex> lock(queueMutex);
+				while (true)
+				{
+					queueChanged.wait(lock, [this, writer]() { return !queues[writer].empty() || stopping; });
+					if (queues[writer].empty())
+					{
+						return;
+					}
+
+					pendingFile file = std::move(queues[writer].front());
+					queues[writer].pop_front();
+					queuedFiles--;
+					filesInProgress++;
+					lock.unlock();
+
+					bool written = writeFile(file);
+
+					lock.lock();
+					queuedBytes -= file.contents.size();
+					filesInProgress--;
+					if (written)
+					{
+						filesWritten++;
+						bytesWritten += file.contents.size();
+					}
+					else
+					{
+						failed = true;
+					}
+					queueChanged.notify_all();
+				}
+			}
+
+			static bool writeFile(const pendingFile& file)
+			{
+				// text mode, so that line endings come out just as they would from an ofstream
+				std::ofstream out(file.filename);
+				if (!out.is_open())
+				{
+					LOG(LogLevel::Error) << "Could not open " << file.filename;
+					return false;
+				}
+				out.write(file.contents.data(), file.contents.size());
+				out.close();
+				if (out.fail())
+				{
+					LOG(LogLevel::Error) << "Could not write " << file.filename;
+					return false;
+				}
+				return true;
+			}
+
+			std::mutex queueMutex;	// guards everything below
+			std::condition_variable queueChanged;	// signalled whenever files are queued or written, or the writers should stop
+			std::vector<std::deque<pendingFile>> queues;	// the files waiting for each writer, oldest first
+			unsigned int queuedFiles;	// how many files are waiting in the queues
+			size_t queuedBytes;	// the size of the files queued or being written
+			unsigned int filesInProgress;	// how many files the writers are writing right now
+			bool stopping;	// whether the writers should stop once their queues are empty
+			std::vector<std::thread> writers;	// the threads writing the files
+			std::chrono::steady_clock::time_point startTime;	// when the writers were started
+			unsigned int filesWritten;	// how many files have been written since the writers were started
+			unsigned long long bytesWritten;	// how much has been written since the writers were started
+			bool failed;	// whether any file couldn't be written since the writers were started
+	};
+
+
+	file::file(): filename(), opened(false)
+	{
+	}
+
+
+	file::file(const std::string& _filename): filename(), opened(false)
+	{
+		open(_filename);
+	}
+
+
+	file::~file()
+	{
+		close();
+	}
+
+
+	void file::open(const std::string& _filename)
+	{
+		close();
+		filename = _filename;
+
+		// the file is only written later, so its folder is checked now to let is_open() catch a bad path the way an ofstream's would
+		boost::filesystem::path folder = boost::filesystem::path(filename).parent_path();
+		boost::system::error_code error;
+		opened = folder.empty() || boost::filesystem::is_directory(folder, error);
+	}
+
+
+	void file::close()
+	{
+		if (opened)
+		{
+			opened = false;
+			buffered_output::write(filename, str());
+			str(std::string());
+		}
+	}
+
+
+	bool createFolders(const std::vector<std::string>& folders)
+	{
+		bool succeeded = true;
+		for (auto folder: folders)
+		{
+			boost::system::error_code error;
+			boost::filesystem::create_directories(folder, error);
+			if (error)
+			{
+				LOG(LogLevel::Error) << "Could not create " << folder << ": " << error.message();
+				succeeded = false;
+			}
+		}
+		return succeeded;
+	}
+
+
+	void write(const std::string& filename, std::string&& contents)
+	{
+		writerPool::get().write(filename, std::move(contents));
+	}
+
+
+	bool finish()
+	{
+		return writerPool::get().finish();
+	}
+}
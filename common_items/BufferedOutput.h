@@ -0,0 +1,74 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef BUFFERED_OUTPUT_H_
+#define BUFFERED_OUTPUT_H_
+
+
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+
+// Output files are built up in memory and handed to a few writer threads, which write each one in a single large write. The converter then
+// doesn't wait on the disk for each of the thousands of small files in a mod. If a file is written more than once, the last write is kept.
+namespace buffered_output
+{
+	// Used in place of an ofstream. What's written to it is queued to be written to the file when it's closed or destroyed. It is only open
+	// if the folder it goes in exists; any error writing the file itself is reported by finish().
+	class file: public std::ostringstream
+	{
+		public:
+			file();
+			explicit file(const std::string& filename);
+			~file();
+
+			void open(const std::string& filename);
+			bool is_open() const { return opened; }
+			void close();
+
+		private:
+			file(const file&) = delete;
+			file& operator=(const file&) = delete;
+
+			std::string filename;	// the file the contents will be written to
+			bool opened;				// whether the file has a name in an existing folder and hasn't been closed yet
+	};
+
+
+	// Creates the given folders, along with any missing folders above them. Returns false if any couldn't be created.
+	bool createFolders(const std::vector<std::string>& folders);
+
+	// Queues contents to be written to filename
+	void write(const std::string& filename, std::string&& contents);
+
+	// Waits until everything queued has been written, then logs how much was written and how quickly. Returns false if any file couldn't
+	// be written.
+	bool finish();
+}
+
+
+
+#endif // BUFFERED_OUTPUT_H_
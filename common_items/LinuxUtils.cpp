@@ -16,7 +16,7 @@ CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
 TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
 SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
-#include "OSCompatabilityLayer.h"
+#include "OSCompatibilityLayer.h"
 
 #include <iostream>
 #include <stdarg.h>
@@ -27,6 +27,11 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include <iconv.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 static boost::system::error_code lastError;
 
 void sprintf_s_Linux (char *__restrict __s, size_t __maxlen, const char *__restrict __format, ...)
@@ -89,6 +94,17 @@ namespace Utils
   {
     return boost::filesystem::exists(path, lastError) && boost::filesystem::is_directory(path, lastError);
   }
+
+  unsigned int getProcessID()
+  {
+    return getpid();
+  }
+
+  bool deleteFolder(const std::string& folder)
+  {
+    boost::filesystem::remove_all(folder, lastError);
+    return !lastError;
+  }
   
   int FromMultiByte(const char* in, size_t inSize, wchar_t* out, size_t outSize)
   {
@@ -115,6 +131,52 @@ namespace Utils
     iconv_close(conv);*/
   }
   
+  mappedFile::mappedFile(const std::string& path):
+    opened(false),
+    data(nullptr),
+    size(0),
+    modifiedTime(0),
+    fileHandle(nullptr),
+    mappingHandle(nullptr)
+  {
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+      return;
+
+    struct stat fileInfo;
+    if(fstat(fd, &fileInfo) == 0)
+    {
+      opened = true;
+      size = fileInfo.st_size;
+      modifiedTime = static_cast<uint64_t>(fileInfo.st_mtim.tv_sec) * 1000000000 + fileInfo.st_mtim.tv_nsec;
+      if(size == 0)
+      {
+        data = ""; // an empty file can't be mapped, but is still a valid file
+      }
+      else
+      {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapping == MAP_FAILED)
+        {
+          opened = false;
+          size = 0;
+        }
+        else
+        {
+          madvise(mapping, size, MADV_SEQUENTIAL);
+          data = static_cast<const char*>(mapping);
+        }
+      }
+    }
+    close(fd); // the mapping keeps its own reference to the file
+  }
+
+  mappedFile::~mappedFile()
+  {
+    if(data != nullptr && size > 0)
+      munmap(const_cast<char*>(data), size);
+  }
+
   void WriteToConsole(LogLevel level, const std::string& logMessage)
   {
     if(level != LogLevel::Debug) // Don't log debug messages to console.
@@ -23,9 +23,16 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "Log.h"
 #include "OSCompatibilityLayer.h"
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
 #include <ctime>
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 
 
@@ -33,61 +40,240 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
+std::atomic<LogLevel> Log::currentLevel(LogLevel::Debug);
+
+
+
+// A finished message waiting to be written
+struct logEntry
+{
+	std::atomic<logEntry*> next;	// the message logged after this one
+	LogLevel level;	// how important the message is
+	time_t time;	// when the message was logged
+	std::string message;	// the message, ending with a newline
+};
+
+
+// Writes queued messages to the console and log.txt on its own thread. Any thread may queue messages without locking: each is linked onto
+// the head of a list, and the writer takes them in order from the tail.
+class logWriter
+{
+	public:
+		static logWriter& get()
+		{
+			static logWriter* writer = new logWriter();	// never deleted, so that it outlives anything logging during shutdown
+			return *writer;
+		}
+
+		void push(LogLevel level, std::string message)
+		{
+			logEntry* entry = new logEntry;
+			entry->next.store(nullptr, std::memory_order_relaxed);
+			entry->level = level;
+			entry->time = time(nullptr);
+			entry->message = std::move(message);
+
+			queued.fetch_add(1, std::memory_order_relaxed);
+			logEntry* previous = head.exchange(entry, std::memory_order_acq_rel);
+			previous->next.store(entry, std::memory_order_release);
+			wake.notify_one();
+		}
+
+		void flush()
+		{
+			waitForWriter(true);
+		}
+
+		void flushOnCrash()
+		{
+			std::set_terminate(onTerminate);
+			signal(SIGSEGV, onCrash);
+			signal(SIGABRT, onCrash);
+			signal(SIGFPE, onCrash);
+			signal(SIGILL, onCrash);
+		}
+
+		void stop()
+		{
+			if (!running.exchange(false))
+			{
+				return;
+			}
+			wake.notify_one();
+			writerThread.join();
+		}
+
+	private:
+		logWriter(): stub(), head(&stub), tail(&stub), queued(0), written(0), flushed(0), running(true), wakeMutex(), wake(), logFile("log.txt", std::ofstream::trunc), cachedTime(0), cachedTimestamp()
+		{
+			stub.next.store(nullptr);
+			writerThread = std::thread(&logWriter::run, this);
+
+			std::atexit([](){ logWriter::get().stop(); });
+		}
+
+		static void onTerminate()
+		{
+			logWriter::get().waitForWriter(false);
+			std::abort();
+		}
+
+		// Only atomics are touched and the writer isn't woken, as a signal handler can't safely lock or do I/O. The writer wakes by itself
+		// often enough to be waited for.
+		static void onCrash(int signalNumber)
+		{
+			logWriter::get().waitForWriter(false);
+			signal(signalNumber, SIG_DFL);
+			raise(signalNumber);
+		}
+
+		// Waits until what's been queued so far is written and flushed to log.txt by the writer, but not forever in case the writer has crashed
+		void waitForWriter(bool wakeWriter)
+		{
+			if (!running.load() || (std::this_thread::get_id() == writerThread.get_id()))
+			{
+				return;
+			}
+
+			unsigned long long target = queued.load();
+			auto giveUp = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+			while ((flushed.load() < target) && (std::chrono::steady_clock::now() < giveUp))
+			{
+				if (wakeWriter)
+				{
+					wake.notify_one();
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		// Takes the oldest message off the queue, or returns false if it's empty
+		bool pop(LogLevel& level, time_t& time, std::string& message)
+		{
+			logEntry* next = tail->next.load(std::memory_order_acquire);
+			if (next == nullptr)
+			{
+				return false;
+			}
+
+			// the popped entry becomes the new stub at the tail, so the old one can go
+			level = next->level;
+			time = next->time;
+			message = std::move(next->message);
+			if (tail != &stub)
+			{
+				delete tail;
+			}
+			tail = next;
+			return true;
+		}
+
+		void run()
+		{
+			LogLevel level;	// how important the message being written is
+			time_t time;	// when the message being written was logged
+			std::string message;	// the message being written
+			while (true)
+			{
+				bool wroteAny = false;	// whether anything was written this time round
+				while (pop(level, time, message))
+				{
+					Utils::WriteToConsole(level, message);
+					write(level, time, message);
+					written.fetch_add(1);
+					wroteAny = true;
+				}
+				if (wroteAny)
+				{
+					logFile.flush();
+					flushed.store(written.load());
+				}
+
+				if (!running.load() && (tail->next.load(std::memory_order_acquire) == nullptr))
+				{
+					break;
+				}
+				std::unique_lock<std::mutex> lock(wakeMutex);
+				wake.wait_for(lock, std::chrono::milliseconds(50));
+			}
+			logFile.flush();
+		}
+
+		void write(LogLevel level, time_t time, const std::string& logMessage)
+		{
+			// messages come in bursts, so the timestamp is only formatted again when the second changes
+			if (time != cachedTime)
+			{
+				cachedTime = time;
+				cachedTimestamp.clear();
+				tm* timeInfo = localtime(&time); // the processed time data
+				if (timeInfo) // whether or not there was an error
+				{
+					char timeBuffer[64];	// the formatted time
+					size_t bytesWritten = strftime(timeBuffer, 64, "%Y-%m-%d %H:%M:%S ", timeInfo);	// the number of digits for the time stamp
+					cachedTimestamp.assign(timeBuffer, bytesWritten);
+				}
+			}
+			logFile << cachedTimestamp;
+
+			switch (level)
+			{
+				case LogLevel::Error:
+					logFile << "  [ERROR] ";
+					break;
+
+				case LogLevel::Warning:
+					logFile << "[WARNING] ";
+					break;
+
+				case LogLevel::Info:
+					logFile << "   [INFO] ";
+					break;
+
+				case LogLevel::Debug:
+					logFile << "  [DEBUG]     ";	// Debug messages are extra indented to further de-emphasize them.
+					break;
+			}
+			logFile << logMessage;
+		}
+
+		logEntry stub;	// the entry at the tail before anything has been written
+		std::atomic<logEntry*> head;	// the most recently queued entry
+		logEntry* tail;	// the last entry written, whose successor is written next
+		std::atomic<unsigned long long> queued;	// how many messages have been queued
+		std::atomic<unsigned long long> written;	// how many messages have been written
+		std::atomic<unsigned long long> flushed;	// how many messages have been written and flushed to log.txt
+		std::atomic<bool> running;	// whether the writer should keep waiting for messages
+		std::mutex wakeMutex;	// guards the writer's sleep
+		std::condition_variable wake;	// wakes the writer when there's something to write
+		std::thread writerThread;	// where the messages are written
+		std::ofstream logFile;	// log.txt, which stays open for the whole run
+		time_t cachedTime;	// the second the cached timestamp is for
+		std::string cachedTimestamp;	// the formatted timestamp for cachedTime
+};
+
+
+
 Log::Log(LogLevel level)
 : logLevel(level)
 {
-	static bool logFileCreated = false;	// whether or not the log file has been created this run of the converter
-	if (!logFileCreated)
-	{
-		std::ofstream logFile("log.txt", std::ofstream::trunc);
-		logFileCreated = true;
-	}
 }
 
 
 Log::~Log()
 {
-	logMessageStream << std::endl;
-	std::string logMessage = logMessageStream.str();
-	Utils::WriteToConsole(logLevel, logMessage);
-	WriteToFile(logLevel, logMessage);
+	logMessageStream << '\n';
+	logWriter::get().push(logLevel, logMessageStream.str());
 }
 
 
-void Log::WriteToFile(LogLevel level, const std::string& logMessage)
+void Log::flush()
 {
-	std::ofstream logFile("log.txt", std::ofstream::app);
-
-	time_t rawtime;	// the raw time data
-	time(&rawtime);
-	tm* timeInfo = localtime(&rawtime); // the processed time data
-	if (timeInfo) // whether or not there was an error
-	{
-		char timeBuffer[64];	// the formatted time
-		size_t bytesWritten = strftime(timeBuffer, 64, "%Y-%m-%d %H:%M:%S ", timeInfo);	// the number of digits for the time stamp
-		if (bytesWritten != 0)
-		{
-			logFile << timeBuffer;
-		}
-	}
-
-	switch (level)
-	{
-		case LogLevel::Error:
-			logFile << "  [ERROR] ";
-			break;
-
-		case LogLevel::Warning:
-			logFile << "[WARNING] ";
-			break;
-
-		case LogLevel::Info:
-			logFile << "   [INFO] ";
-			break;
-
-		case LogLevel::Debug:
-			logFile << "  [DEBUG]     ";	// Debug messages are extra indented to further de-emphasize them.
-			break;
-	}
-	logFile << logMessage;
+	logWriter::get().flush();
+}
+
+
+void Log::flushOnCrash()
+{
+	logWriter::get().flushOnCrash();
 }
@@ -26,12 +26,19 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
+#include <atomic>
 #include <sstream>
 #include <string>
 
 
 
-#define LOG(LOG_LEVEL) Log(LOG_LEVEL)
+// Messages less important than LOG_COMPILED_LEVEL are compiled out of LOG statements entirely. Those less important than the level set with
+// Log::setLevel() are skipped at run time. Either way, the arguments of a skipped LOG statement are never formatted.
+#ifndef LOG_COMPILED_LEVEL
+#define LOG_COMPILED_LEVEL LogLevel::Debug
+#endif
+
+#define LOG(LOG_LEVEL) if (!Log::isEnabled(LOG_LEVEL)) {} else Log(LOG_LEVEL)
 
 
 
@@ -45,6 +52,8 @@ enum class LogLevel
 
 
 
+// Messages are queued as they're finished and written to the console and log.txt by a background thread, so logging doesn't wait on either.
+// Everything queued is written before the program exits, and also when it crashes if the program has asked for that with flushOnCrash().
 class Log
 {
 	public:
@@ -58,11 +67,24 @@ class Log
 			return *this;
 		}
 
+		static bool isEnabled(LogLevel level)
+		{
+			return (level <= LOG_COMPILED_LEVEL) && (level <= currentLevel.load(std::memory_order_relaxed));
+		}
+		static void setLevel(LogLevel level) { currentLevel.store(level, std::memory_order_relaxed); }
+
+		// Waits until everything logged so far has been written
+		static void flush();
+
+		// Installs terminate and crash signal handlers that wait for everything logged so far to be written. Meant to be called once from
+		// main, as it replaces any handlers the program already has.
+		static void flushOnCrash();
+
 	private:
-		static void WriteToFile(LogLevel, const std::string& logMessage);
+		static std::atomic<LogLevel> currentLevel;	// the least important level that is logged
 
 		LogLevel logLevel;							// the current log level
 		std::ostringstream logMessageStream;	// the output stream to the log file
 };
 
-#endif // LOG_H_
\ No newline at end of file
+#endif // LOG_H_
@@ -92,6 +92,8 @@ namespace Utils
 	bool DoesFileExist(const std::string& path);
 	// Returns true if the specified folder exists (and is a folder rather than a file).
 	bool doesFolderExist(const std::string& path);
+	// Returns the ID of this process, which no other running process shares.
+	unsigned int getProcessID();
 
 	void WriteToConsole(LogLevel level, const std::string& logMessage);
 
@@ -103,6 +105,32 @@ namespace Utils
 
 	std::string GetFileFromTag(const std::string& directoryPath, const std::string& tag);
 
+	// A read-only view of a whole file, memory-mapped where the OS allows it.
+	// The contents stay valid until the mappedFile is destroyed.
+	class mappedFile
+	{
+		public:
+			mappedFile(const std::string& path);
+			~mappedFile();
+
+			bool isOpen() const { return opened; }
+			const char* begin() const { return data; }
+			const char* end() const { return data + size; }
+			size_t getSize() const { return size; }
+			uint64_t getModifiedTime() const { return modifiedTime; }
+
+		private:
+			mappedFile(const mappedFile&) = delete;
+			mappedFile& operator=(const mappedFile&) = delete;
+
+			bool			opened;				// whether or not the file could be opened
+			const char*	data;					// the contents of the file
+			size_t		size;					// the size of the file in bytes
+			uint64_t		modifiedTime;		// when the file was last written, in the OS's own units
+			void*			fileHandle;			// the OS handle for the file, if one is kept open
+			void*			mappingHandle;		// the OS handle for the mapping, if one is kept open
+	};
+
 	std::string convertUTF8ToASCII(std::string UTF8);
 	std::string convertUTF8To8859_15(std::string UTF8);
 	std::string convertUTF16ToUTF8(std::wstring UTF16);
@@ -45,61 +45,139 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "Object.h"
 #include "Log.h"
-#include "ParadoxParser8859_15.h"
-#include "ParadoxParserUTF8.h"
+#include "ParadoxParserCore.h"
+#include "OSCompatibilityLayer.h"
 #include <sstream> 
 #include <fstream>
 #include <algorithm>
 #include <iostream>
 #include <assert.h>
+#include <thread>
 
 
 
+const unsigned int childIndex::none;
+
+
+static const parser_core::lazyBody materialising = { nullptr, nullptr, nullptr };	// marks an Object whose sub-objects another thread is parsing
+
+
 Object::Object(string k) :
-objects(),
+leaf(false),
+isObjList(false),
 strVal(),
+objects(),
+tokens(),
+ownedArena(),
+index(nullptr),
+pending(nullptr)
+{
+	key = objectKeys::intern(k);
+}
+
+
+Object::Object(unsigned int keySymbol, objectArena* arena) :
+key(keySymbol),
 leaf(false),
-isObjList(false)
+isObjList(false),
+strVal(),
+objects(arenaAllocator<Object*>(arena)),
+tokens(arenaAllocator<string>(arena)),
+ownedArena(),
+index(nullptr),
+pending(nullptr)
 {
-	key = k;
 }
 
 
 Object::~Object() {
-	for (objiter i = objects.begin(); i != objects.end(); ++i)
+	// objects in an arena are destroyed along with the arena
+	for (auto i = objects.begin(); i != objects.end(); ++i)
 	{
-		delete (*i);
+		if (!(*i)->isArenaOwned())
+		{
+			delete (*i);
+		}
 	}
 	if (br == this)
 	{
 		br = 0;
 	}
+	delete index.load();
 }
 
 
 Object::Object(Object* other) :
-objects(),
-strVal(other->strVal),
+key(other->key),
 leaf(other->leaf),
-isObjList(other->isObjList)
+isObjList(other->isObjList),
+strVal(other->strVal),
+objects(),
+tokens(),
+ownedArena(),
+index(nullptr),
+pending(nullptr)
 {
-	key = other->key;
-	for (vector<Object*>::iterator i = other->objects.begin(); i != other->objects.end(); ++i)
+	other->materialise();
+	isObjList = other->isObjList;
+	tokens.assign(other->tokens.begin(), other->tokens.end());
+	for (auto i = other->objects.begin(); i != other->objects.end(); ++i)
 	{
 		objects.push_back(new Object(*i));
 	}
 }
 
 
+objectArena* Object::getArena()
+{
+	objectArena* arena = objects.get_allocator().getArena();	// the arena this object lives in
+	if (arena != nullptr)
+	{
+		return arena;
+	}
+	if (!ownedArena)
+	{
+		ownedArena.reset(new objectArena);
+	}
+	return ownedArena.get();
+}
+
+
+void Object::parsePending() const
+{
+	const parser_core::lazyBody* body = pending.load(memory_order_acquire);	// the text to parse
+	if ((body != &materialising) && (body != nullptr) && pending.compare_exchange_strong(body, &materialising, memory_order_acq_rel))
+	{
+		// the sub-objects are parsed into an arena of this thread's, and this object takes over the lists
+		Object* parsed = parser_core::parseLazyBody(*body, key);	// an object holding the parsed sub-objects
+		Object* self = const_cast<Object*>(this);
+		self->objects = move(parsed->objects);
+		self->tokens = move(parsed->tokens);
+		self->isObjList = parsed->isObjList;
+		pending.store(nullptr, memory_order_release);
+		return;
+	}
+
+	// another thread is parsing the sub-objects already
+	while (pending.load(memory_order_acquire) != nullptr)
+	{
+		this_thread::yield();
+	}
+}
+
+
 void Object::setValue(string val)
 {
-	strVal = val;
+	materialise();
+	strVal = move(val);
 	leaf = true;
 }
 
 
 void Object::setValue(Object* val)
 {
+	materialise();
+	clearIndex();
 	objects.push_back(val);
 	leaf = false;
 }
@@ -107,6 +185,8 @@ void Object::setValue(Object* val)
 
 void Object::unsetValue(string val)
 {
+	materialise();
+	clearIndex();
 	for (unsigned int i = 0; i < objects.size(); ++i)
 	{
 		if (objects[i]->getKey() != val)
@@ -129,64 +209,166 @@ void Object::setLeaf(string key, string val)
 
 void Object::setValue(vector<Object*> val)
 {
-	objects = val;
+	materialise();
+	clearIndex();
+	objects.assign(val.begin(), val.end());
 }
 
 
 void Object::addToList(string val)
 {
+	materialise();
 	isObjList = true;
-	if (strVal.size() > 0)
+	tokens.push_back(val);
+}
+
+
+void Object::addToList(vector<string>::const_iterator begin, vector<string>::const_iterator end)
+{
+	materialise();
+	isObjList = true;
+	tokens.insert(tokens.end(), begin, end);
+}
+
+
+string Object::listToString() const
+{
+	// the list is only quoted on demand, rather than keeping a second copy of every token
+	string list;	// the quoted tokens
+	for (auto itr = tokens.begin(); itr != tokens.end(); ++itr)
 	{
-		strVal += " \"";
+		if (list.size() > 0)
+		{
+			list += " ";
+		}
+		list += "\"";
+		list += *itr;
+		list += "\"";
 	}
-	else
+	return list;
+}
+
+
+string Object::getLeaf() const
+{
+	materialise();
+	if (isObjList)
 	{
-		strVal += "\"";
+		return listToString();
 	}
-	strVal += val;
-	strVal += "\"";
-	tokens.push_back(val);
+	return strVal;
 }
 
 
-void Object::addToList(vector<string>::iterator begin, vector<string>::iterator end)
+vector<Object*> Object::getValue(string key) const
 {
-	isObjList = true;
-	for (vector<string>::iterator itr = begin; itr != end; ++itr)
+	vector<Object*> ret;	// the objects to return
+	for (auto child: getRange(key))
+	{
+		ret.push_back(child);
+	}
+	return ret;
+}
+
+
+Object* Object::getFirst(const string& key) const
+{
+	return getRange(key).front();
+}
+
+
+objectRange Object::getRange(const string& key) const
+{
+	materialise();
+	Object* const* children = objects.data();	// the sub-objects to search
+	const unsigned int numChildren = objects.size();
+	unsigned int symbol;	// the symbol for the key
+	if (!objectKeys::find(key, symbol))
+	{
+		return objectRange(children, numChildren, 0, nullptr, childIndex::none);
+	}
+
+	const childIndex* keyIndex = getIndex();	// the index of the children, if there are enough of them for one
+	if (keyIndex != nullptr)
+	{
+		auto first = keyIndex->firstPosition.find(symbol);
+		unsigned int firstPosition = (first == keyIndex->firstPosition.end()) ? childIndex::none : first->second;
+		return objectRange(children, numChildren, symbol, keyIndex, firstPosition);
+	}
+
+	for (unsigned int i = 0; i < numChildren; i++)
 	{
-		if (strVal.size() > 0)
+		if (children[i]->key == symbol)
 		{
-			strVal += "\" \"";
+			return objectRange(children, numChildren, symbol, nullptr, i);
 		}
-		else
+	}
+	return objectRange(children, numChildren, symbol, nullptr, childIndex::none);
+}
+
+
+unsigned int objectRange::nextPosition(unsigned int position) const
+{
+	if (index != nullptr)
+	{
+		return index->nextSameKey[position];
+	}
+	for (unsigned int i = position + 1; i < numChildren; i++)
+	{
+		if (children[i]->key == symbol)
 		{
-			strVal += "\"";
+			return i;
 		}
-		strVal += *itr;
 	}
-	strVal += "\"";
-	tokens.insert(tokens.end(), begin, end);
+	return childIndex::none;
 }
 
 
-vector<Object*> Object::getValue(string key) const
+const childIndex* Object::getIndex() const
 {
-	vector<Object*> ret;	// the objects to return
-	for (vector<Object*>::const_iterator i = objects.begin(); i != objects.end(); ++i)
+	childIndex* existing = index.load(memory_order_acquire);	// the index, if it's already been built
+	if ((existing != nullptr) || (objects.size() < indexThreshold))
+	{
+		return existing;
+	}
+
+	childIndex* newIndex = new childIndex;
+	newIndex->nextSameKey.resize(objects.size(), childIndex::none);
+	unordered_map<unsigned int, unsigned int> lastPosition;	// the latest child seen with each key
+	for (unsigned int i = 0; i < objects.size(); i++)
 	{
-		if ((*i)->getKey() != key)
+		auto last = lastPosition.find(objects[i]->key);
+		if (last == lastPosition.end())
 		{
-			continue;
+			newIndex->firstPosition.insert(make_pair(objects[i]->key, i));
+			lastPosition.insert(make_pair(objects[i]->key, i));
+		}
+		else
+		{
+			newIndex->nextSameKey[last->second] = i;
+			last->second = i;
 		}
-		ret.push_back(*i);
 	}
-	return ret;
+
+	// another thread may have indexed this object at the same time, in which case its index is used instead
+	if (!index.compare_exchange_strong(existing, newIndex, memory_order_acq_rel))
+	{
+		delete newIndex;
+		return existing;
+	}
+	return newIndex;
+}
+
+
+void Object::clearIndex()
+{
+	delete index.exchange(nullptr);
 }
 
 
 string Object::getToken(const int index)
 {
+	materialise();
 	if (!isObjList)
 	{
 		return "";
@@ -205,6 +387,7 @@ string Object::getToken(const int index)
 
 int Object::numTokens()
 {
+	materialise();
 	if (!isObjList)
 	{
 		return 0;
@@ -215,8 +398,9 @@ int Object::numTokens()
 
 vector<string> Object::getKeys()
 {
+	materialise();
 	vector<string> ret;	// the keys to return
-	for (vector<Object*>::iterator i = objects.begin(); i != objects.end(); ++i)
+	for (auto i = objects.begin(); i != objects.end(); ++i)
 	{
 		string curr = (*i)->getKey();	// the current key
 		if (find(ret.begin(), ret.end(), curr) != ret.end())
@@ -231,65 +415,72 @@ vector<string> Object::getKeys()
 
 string Object::getLeaf(string leaf) const
 {
-	vector<Object*> leaves = getValue(leaf); // the objects to return
-	if (0 == leaves.size())
+	Object* leafObj = getFirst(leaf); // the object to return
+	if (leafObj == nullptr)
 	{
-		LOG(LogLevel::Error) << "Error: Cannot find leaf " << leaf << " in object\n" << *this;
-		assert(leaves.size());
+		LOG(LogLevel::Error) << "Error: Cannot find leaf " << leaf << " in object\n" << toString();
+		assert(leafObj);
 	}
-	return leaves[0]->getLeaf();
+	return leafObj->getLeaf();
 }
 
 
 ostream& operator<< (ostream& os, const Object& obj)
 {
 	static int indent = 0; // the level of indentation to output to
+	obj.materialise();
 	for (int i = 0; i < indent; i++)
 	{
 		os << "\t";
 	}
 	if (obj.leaf) {
-		os << obj.key << "=" << obj.strVal << "\n";
+		os << obj.getKey() << "=" << obj.strVal << "\n";
 		return os;
 	}
 	if (obj.isObjList)
 	{
-		os << obj.key << "={" << obj.strVal << " }\n";
+		os << obj.getKey() << "={" << obj.listToString() << " }\n";
 		return os;
 	}
 
-	if ((&obj != parser_UTF8::getTopLevel()) && (&obj != parser_8859_15::getTopLevel()))
+	os << obj.getKey() << "=\n";
+	for (int i = 0; i < indent; i++)
 	{
-		os << obj.key << "=\n";
-		for (int i = 0; i < indent; i++)
-		{
-			os << "\t";
-		}
-		os << "{\n";
-		indent++;
+		os << "\t";
 	}
+	os << "{\n";
+	indent++;
 	for (auto i: obj.objects)
 	{
 		os << *i;
 	}
-	if ((&obj != parser_UTF8::getTopLevel()) && (&obj != parser_8859_15::getTopLevel()))
+	indent--;
+	for (int i = 0; i < indent; i++)
 	{
-		indent--;
-		for (int i = 0; i < indent; i++)
-		{
-			os << "\t";
-		}
-		os << "}\n";
+		os << "\t";
 	}
+	os << "}\n";
 	return os;
 }
 
 
+// The object a file was parsed into is written as the file itself, without a key or braces of its own
+void Object::writeTopLevel(ostream& os) const
+{
+	materialise();
+	for (auto i: objects)
+	{
+		os << *i;
+	}
+}
+
+
 void Object::keyCount()
 {
+	materialise();
 	if (leaf)
 	{
-		cout << key << " : 1\n";
+		cout << getKey() << " : 1\n";
 		return;
 	}
 
@@ -329,9 +520,10 @@ void Object::keyCount()
 
 void Object::keyCount(map<string, int>& counter)
 {
-	for (vector<Object*>::iterator i = objects.begin(); i != objects.end(); ++i)
+	materialise();
+	for (auto i = objects.begin(); i != objects.end(); ++i)
 	{
-		counter[(*i)->key]++;
+		counter[(*i)->getKey()]++;
 		if ((*i)->leaf)
 		{
 			continue;
@@ -343,16 +535,19 @@ void Object::keyCount(map<string, int>& counter)
 
 void Object::printTopLevel()
 {
-	for (vector<Object*>::iterator i = objects.begin(); i != objects.end(); ++i)
+	materialise();
+	for (auto i = objects.begin(); i != objects.end(); ++i)
 	{
-		cout << (*i)->key << endl;
+		cout << (*i)->getKey() << endl;
 	}
 }
 
 
 void Object::removeObject(Object* target)
 {
-	vector<Object*>::iterator pos = find(objects.begin(), objects.end(), target);	// the position of the object to be removed
+	materialise();
+	clearIndex();
+	auto pos = find(objects.begin(), objects.end(), target);	// the position of the object to be removed
 	if (pos == objects.end())
 	{
 		return;
@@ -363,15 +558,18 @@ void Object::removeObject(Object* target)
 
 void Object::addObject(Object* target)
 {
+	materialise();
+	clearIndex();
 	objects.push_back(target);
 }
 
 
 void Object::addObjectAfter(Object* target, string key)
 {
-	vector<Object*>::iterator i;
-
-	for (i = objects.begin(); i != objects.end(); ++i)
+	materialise();
+	clearIndex();
+	auto i = objects.begin();
+	for (; i != objects.end(); ++i)
 	{
 		if ((*i)->getKey() == key)
 		{
@@ -430,39 +628,39 @@ void setFlt(string name, const double val, Object* branch)
 
 double Object::safeGetFloat(string k, const double def)
 {
-	objvec vec = getValue(k);	// the objects with the keys to be returned
-	if (0 == vec.size()) return def;
-	return stof(vec[0]->getLeaf());
+	Object* obj = getFirst(k);	// the object with the key to be returned
+	if (obj == nullptr) return def;
+	return stof(obj->getLeaf());
 }
 
 string Object::safeGetString(string k, string def)
 {
-	objvec vec = getValue(k);	// the objects with the strings to be returned
-	if (0 == vec.size())
+	Object* obj = getFirst(k);	// the object with the string to be returned
+	if (obj == nullptr)
 	{
 		return def;
 	}
-	return vec[0]->getLeaf();
+	return obj->getLeaf();
 }
 
 int Object::safeGetInt(string k, const int def)
 {
-	objvec vec = getValue(k);	// the objects with the ints to be returned
-	if (0 == vec.size())
+	Object* obj = getFirst(k);	// the object with the int to be returned
+	if (obj == nullptr)
 	{
 		return def;
 	}
-	return stoi(vec[0]->getLeaf());
+	return stoi(obj->getLeaf());
 }
 
 Object* Object::safeGetObject(string k, Object* def)
 {
-	objvec vec = getValue(k);	// the objects with the objects to be returned 
-	if (0 == vec.size())
+	Object* obj = getFirst(k);	// the object with the object to be returned 
+	if (obj == nullptr)
 	{
 		return def;
 	}
-	return vec[0];
+	return obj;
 }
 
 
@@ -48,29 +48,91 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #define OBJECT_H
 
 
+#include <atomic>
 #include <map> 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <string> 
+#include "ObjectArena.h"
 using namespace std;
 
 
+class Object;
+namespace parser_core
+{
+  struct lazyBody;
+}
+
+
+// A lookup table from each key to the positions of the children with that key, built for Objects with many children.
+struct childIndex
+{
+  static const unsigned int none = 0xFFFFFFFF;
+
+  unordered_map<unsigned int, unsigned int> firstPosition;	// the first child with each key
+  vector<unsigned int> nextSameKey;								// for each child, the next child with the same key, or none
+};
+
+
+// The children of an Object that share a key, in their original order. Iterating it doesn't allocate.
+class objectRange
+{
+public:
+  class iterator
+  {
+  public:
+    iterator (const objectRange* r, unsigned int p) : range(r), position(p) {}
+    Object* operator* () const {return range->children[position];}
+    iterator& operator++ () {position = range->nextPosition(position); return *this;}
+    bool operator== (const iterator& other) const {return position == other.position;}
+    bool operator!= (const iterator& other) const {return position != other.position;}
+
+  private:
+    const objectRange* range;	// the range being iterated
+    unsigned int position;		// the index of the current child, or childIndex::none at the end
+  };
+
+  objectRange (Object* const* c, unsigned int n, unsigned int s, const childIndex* i, unsigned int first) :
+    children(c), numChildren(n), symbol(s), index(i), firstPosition(first) {}
+  iterator begin () const {return iterator(this, firstPosition);}
+  iterator end () const {return iterator(this, childIndex::none);}
+  bool empty () const {return firstPosition == childIndex::none;}
+  Object* front () const {return empty() ? nullptr : children[firstPosition];}
+
+private:
+  unsigned int nextPosition (unsigned int position) const;
+
+  Object* const* children;		// all the children of the Object
+  unsigned int numChildren;		// the number of children
+  unsigned int symbol;				// the key being looked up
+  const childIndex* index;		// the Object's key index, if it has one
+  unsigned int firstPosition;	// the first child with the key, or childIndex::none if there are none
+};
+
+
 class Object {
   friend ostream& operator<< (ostream& o, const Object& i);
+  friend class objectRange;
 
 public:
   Object (string k);
+  Object (unsigned int keySymbol, objectArena* arena);
   ~Object (); 
   Object (Object* other);
 
   void setValue (Object* val);
   void setValue (string val);
   void setValue (vector<Object*> val);
-  string getKey () {return key;} 
+  const string& getKey () const {return objectKeys::getKey(key);}
+  unsigned int getKeySymbol () const {return key;}
   vector<string> getKeys (); 
   vector<Object*> getValue (string key) const;
-  string getLeaf () const {return strVal;}
+  Object* getFirst (const string& key) const;
+  objectRange getRange (const string& key) const;
+  string getLeaf () const;
   string getLeaf (string leaf) const;
-  vector<Object*> getLeaves () {return objects;}
+  vector<Object*> getLeaves () {materialise(); return vector<Object*>(objects.begin(), objects.end());}
   void removeObject (Object* target); 
   void addObject (Object* target); 
   void addObjectAfter(Object* target, string key);
@@ -80,10 +142,10 @@ public:
   void keyCount (map<string, int>& counter);
   void setObjList (const bool l = true) {isObjList = l;}
   string getToken (int index); 
-  vector<string> getTokens() { return tokens; }
+  vector<string> getTokens() { materialise(); return vector<string>(tokens.begin(), tokens.end()); }
   int numTokens (); 
   void addToList (string val); 
-  void addToList (vector<string>::iterator begin, vector<string>::iterator end);
+  void addToList (vector<string>::const_iterator begin, vector<string>::const_iterator end);
   void printTopLevel ();
   inline bool isLeaf () {return leaf;}
   double safeGetFloat (string k, double def = 0);
@@ -91,14 +153,31 @@ public:
   int safeGetInt (string k, int def = 0);
   Object* safeGetObject (string k, Object* def = 0);
   string toString () const; 
+  void writeTopLevel (ostream& os) const;
+  objectArena* getArena ();
+  bool isArenaOwned () const {return objects.get_allocator().getArena() != nullptr;}
+  void setLazyBody (const parser_core::lazyBody* body) {pending.store(body, memory_order_release);}
+  const parser_core::lazyBody* getLazyBody () const {return pending.load(memory_order_acquire);}
   
 private:
-  string key;						// the higher level or LHS key for this object
-  string strVal;					// the textual value for this object
-  vector<Object*> objects;		// any sub-objects
+  string listToString () const;
+  const childIndex* getIndex () const;
+  void clearIndex ();
+  // Objects from a lazy parse only parse their sub-objects when something first looks at them
+  void materialise () const {if (pending.load(memory_order_acquire) != nullptr) parsePending();}
+  void parsePending () const;
+
+  static const unsigned int indexThreshold = 16;	// Objects with at least this many children get a key index
+
+  unsigned int key;				// the higher level or LHS key for this object, as a symbol in objectKeys
   bool leaf;						// whether or not this is a leaf object
   bool isObjList;					// whether or not this is an object list object
-  vector<string> tokens;		// The tokens if this is a list object 
+  string strVal;					// the textual value for this object
+  vector<Object*, arenaAllocator<Object*> > objects;		// any sub-objects
+  vector<string, arenaAllocator<string> > tokens;			// The tokens if this is a list object 
+  unique_ptr<objectArena> ownedArena;	// the arena for any sub-objects, if this object isn't in an arena itself
+  mutable atomic<childIndex*> index;	// the key index for the sub-objects, built on the first lookup
+  mutable atomic<const parser_core::lazyBody*> pending;	// the unparsed text of the sub-objects, if they haven't been needed yet
 };
 
 extern ostream& operator<< (ostream& os, const Object& i);
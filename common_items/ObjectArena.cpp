@@ -0,0 +1,273 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#include "ObjectArena.h"
+#include "Object.h"
+#include "Log.h"
+#include <cstdlib>
+#include <new>
+
+
+
+objectKeys::symbolTable::symbolTable(size_t capacity):
+	mask(capacity - 1),
+	slots(new atomic<uint64_t>[capacity])
+{
+	for (size_t i = 0; i < capacity; i++)
+	{
+		slots[i].store(0, memory_order_relaxed);
+	}
+}
+
+
+objectKeys::objectKeys():
+	tableLock(),
+	table(nullptr),
+	tables(),
+	pages(),
+	numKeys(0)
+{
+	pages.reserve(maxPages);
+	tables.push_back(unique_ptr<symbolTable>(new symbolTable(initialTableCapacity)));
+	table.store(tables.back().get(), memory_order_release);
+}
+
+
+objectKeys::~objectKeys()
+{
+	for (auto page: pages)
+	{
+		delete[] page;
+	}
+}
+
+
+unsigned int objectKeys::actuallyIntern(const string& key)
+{
+	size_t hash = std::hash<string>()(key);	// where the key goes in the table
+	unsigned int symbol;	// the symbol for the key
+	if (lookUp(key, hash, symbol))
+	{
+		return symbol;
+	}
+
+	lock_guard<mutex> guard(tableLock);
+
+	// another thread may have added the key since it was looked for
+	if (lookUp(key, hash, symbol))
+	{
+		return symbol;
+	}
+
+	if ((numKeys % pageSize) == 0)
+	{
+		if (pages.size() == maxPages)
+		{
+			LOG(LogLevel::Error) << "Too many distinct keys to store: " << numKeys;
+			exit(-1);
+		}
+		pages.push_back(new string[pageSize]);
+	}
+
+	symbol = numKeys++;
+	pages[symbol / pageSize][symbol % pageSize] = key;
+
+	// the table is kept at most half full, so that lookups stay short
+	if ((static_cast<size_t>(numKeys) * 2) > (table.load(memory_order_relaxed)->mask + 1))
+	{
+		growTable();
+	}
+	addSymbol(table.load(memory_order_relaxed), hash, symbol);
+	return symbol;
+}
+
+
+bool objectKeys::actuallyFind(const string& key, unsigned int& symbol) const
+{
+	return lookUp(key, std::hash<string>()(key), symbol);
+}
+
+
+bool objectKeys::lookUp(const string& key, size_t hash, unsigned int& symbol) const
+{
+	const symbolTable* current = table.load(memory_order_acquire);	// the table to look in
+	const uint32_t hashPart = static_cast<uint32_t>(hash);				// the part of the hash that's kept in the slots
+	for (size_t slot = hash & current->mask; ; slot = (slot + 1) & current->mask)
+	{
+		uint64_t entry = current->slots[slot].load(memory_order_acquire);	// the symbol in this slot, if any
+		if (entry == 0)
+		{
+			return false;
+		}
+		if (static_cast<uint32_t>(entry >> 32) == hashPart)
+		{
+			unsigned int candidate = static_cast<uint32_t>(entry) - 1;	// a symbol whose key may match
+			if (actuallyGetKey(candidate) == key)
+			{
+				symbol = candidate;
+				return true;
+			}
+		}
+	}
+}
+
+
+void objectKeys::addSymbol(symbolTable* into, size_t hash, unsigned int symbol)
+{
+	const uint64_t entry = (static_cast<uint64_t>(static_cast<uint32_t>(hash)) << 32) | (static_cast<uint64_t>(symbol) + 1);	// the new slot contents
+	size_t slot = hash & into->mask;	// where the symbol goes
+	while (into->slots[slot].load(memory_order_relaxed) != 0)
+	{
+		slot = (slot + 1) & into->mask;
+	}
+	into->slots[slot].store(entry, memory_order_release);
+}
+
+
+void objectKeys::growTable()
+{
+	const symbolTable* old = table.load(memory_order_relaxed);	// the full table
+	unique_ptr<symbolTable> bigger(new symbolTable((old->mask + 1) * 2));	// the table to replace it
+	for (size_t slot = 0; slot <= old->mask; slot++)
+	{
+		uint64_t entry = old->slots[slot].load(memory_order_relaxed);	// the symbol in this slot, if any
+		if (entry != 0)
+		{
+			// the slots only keep the low half of the hash, which is all a table with fewer than 2^32 slots uses to place them
+			addSymbol(bigger.get(), static_cast<uint32_t>(entry >> 32), static_cast<uint32_t>(entry) - 1);
+		}
+	}
+
+	table.store(bigger.get(), memory_order_release);
+	tables.push_back(move(bigger));
+}
+
+
+objectArena::objectArena():
+	blocks(),
+	current(nullptr),
+	remaining(0),
+	objectBlocks(),
+	objectsInLastBlock(objectsPerBlock),
+	objectsDestroyed(false),
+	adoptedArenas(),
+	keptResources()
+{
+}
+
+
+objectArena::~objectArena()
+{
+	destroyObjects();
+	for (auto objectBlock: objectBlocks)
+	{
+		::operator delete(objectBlock);
+	}
+
+	for (auto block: blocks)
+	{
+		delete[] block;
+	}
+}
+
+
+void objectArena::destroyObjects()
+{
+	// Objects can refer to Objects in adopted arenas and the other way round, so every Object in the tree is destroyed before any memory is freed
+	if (objectsDestroyed)
+	{
+		return;
+	}
+	objectsDestroyed = true;
+
+	for (auto& adopted: adoptedArenas)
+	{
+		adopted->destroyObjects();
+	}
+	for (unsigned int i = 0; i < objectBlocks.size(); i++)
+	{
+		size_t numObjects = (i + 1 == objectBlocks.size()) ? objectsInLastBlock : objectsPerBlock;	// the number of Objects in this block
+		for (size_t j = 0; j < numObjects; j++)
+		{
+			objectBlocks[i][j].~Object();
+		}
+	}
+}
+
+
+Object* objectArena::newObject(unsigned int keySymbol)
+{
+	if (objectsInLastBlock == objectsPerBlock)
+	{
+		objectBlocks.push_back(static_cast<Object*>(::operator new(sizeof(Object) * objectsPerBlock)));
+		objectsInLastBlock = 0;
+	}
+
+	Object* newObj = new (&objectBlocks.back()[objectsInLastBlock]) Object(keySymbol, this);
+	objectsInLastBlock++;
+	return newObj;
+}
+
+
+Object* objectArena::newObject(const string& key)
+{
+	return newObject(objectKeys::intern(key));
+}
+
+
+void* objectArena::allocate(size_t bytes, size_t alignment)
+{
+	size_t padding = (alignment - (reinterpret_cast<size_t>(current) % alignment)) % alignment;	// the bytes needed to align the allocation
+	if (padding + bytes > remaining)
+	{
+		if (bytes > blockSize / 4)
+		{
+			// large requests get their own block, so they don't waste the rest of the current one
+			char* bigBlock = new char[bytes];
+			blocks.push_back(bigBlock);
+			return bigBlock;
+		}
+
+		current = new char[blockSize];
+		blocks.push_back(current);
+		remaining = blockSize;
+		padding = 0;
+	}
+
+	void* allocation = current + padding;	// the memory handed out
+	current += padding + bytes;
+	remaining -= padding + bytes;
+	return allocation;
+}
+
+
+void objectArena::adopt(unique_ptr<objectArena> other)
+{
+	adoptedArenas.push_back(move(other));
+}
+
+
+void objectArena::keep(shared_ptr<void> resource)
+{
+	keptResources.push_back(move(resource));
+}
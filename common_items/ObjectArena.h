@@ -0,0 +1,193 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef OBJECT_ARENA_H_
+#define OBJECT_ARENA_H_
+
+
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+using namespace std;
+
+
+
+class Object;
+
+
+// The table of every Object key seen this run. Each distinct key is stored once and referred to by a 32-bit symbol.
+// Keys that are already in the table are found without locking, so that threads reading Objects at the same time don't wait on each other.
+// Only adding a new key takes the lock.
+class objectKeys
+{
+	public:
+		static unsigned int intern(const string& key)
+		{
+			return getInstance()->actuallyIntern(key);
+		}
+		// Finds the symbol for a key without adding it. Returns false if the key has never been seen.
+		static bool find(const string& key, unsigned int& symbol)
+		{
+			return getInstance()->actuallyFind(key, symbol);
+		}
+		static const string& getKey(unsigned int symbol)
+		{
+			return getInstance()->actuallyGetKey(symbol);
+		}
+
+	private:
+		static objectKeys* getInstance()
+		{
+			static objectKeys instance;
+			return &instance;
+		}
+
+		objectKeys();
+		~objectKeys();
+		objectKeys(const objectKeys&) = delete;
+		objectKeys& operator=(const objectKeys&) = delete;
+
+		// An open-addressed hash table from keys to symbols. Each slot holds part of the key's hash in its high half and the symbol plus one in
+		// its low half, or zero if it's empty. Slots are only ever filled, and a full table is replaced by a bigger one rather than changed.
+		struct symbolTable
+		{
+			explicit symbolTable(size_t capacity);
+
+			size_t								mask;		// the capacity less one, to turn hashes into slots
+			unique_ptr<atomic<uint64_t>[]>	slots;	// the entries
+		};
+
+		unsigned int actuallyIntern(const string& key);
+		bool actuallyFind(const string& key, unsigned int& symbol) const;
+		const string& actuallyGetKey(unsigned int symbol) const
+		{
+			return pages[symbol / pageSize][symbol % pageSize];
+		}
+		bool lookUp(const string& key, size_t hash, unsigned int& symbol) const;
+		void addSymbol(symbolTable* table, size_t hash, unsigned int symbol);
+		void growTable();
+
+		static const unsigned int pageSize = 4096;				// the number of keys stored together
+		static const unsigned int maxPages = 16384;				// the most pages there can be, so that pages never moves
+		static const size_t initialTableCapacity = 8192;		// the number of slots in the first table, which must be a power of two
+
+		mutex										tableLock;	// guards adding keys
+		atomic<symbolTable*>					table;		// the current table, which is read without locking
+		vector<unique_ptr<symbolTable>>	tables;		// every table there has been, since a reader may still be using an old one
+		vector<string*>						pages;		// the keys, indexed by symbol
+		unsigned int							numKeys;		// the number of keys stored
+};
+
+
+// A bump allocator for the Objects of one parse, along with their child and token lists.
+// Everything it holds is released together when the arena is destroyed.
+class objectArena
+{
+	public:
+		objectArena();
+		~objectArena();
+
+		Object* newObject(unsigned int keySymbol);
+		Object* newObject(const string& key);
+		void* allocate(size_t bytes, size_t alignment);
+
+		// Takes ownership of another arena, so that its Objects live as long as this arena's do.
+		void adopt(unique_ptr<objectArena> other);
+		// Keeps something the Objects refer to, such as the text of a lazy parse, alive for as long as they are.
+		void keep(shared_ptr<void> resource);
+
+	private:
+		objectArena(const objectArena&) = delete;
+		objectArena& operator=(const objectArena&) = delete;
+
+		void destroyObjects();
+
+		static const size_t blockSize = 1 << 20;			// the size of each block of raw memory
+		static const size_t objectsPerBlock = 8192;		// the number of Objects in each block of Objects
+
+		vector<char*>		blocks;					// the blocks of raw memory
+		char*					current;					// the next free byte in the current block
+		size_t				remaining;				// the number of free bytes in the current block
+		vector<Object*>	objectBlocks;			// the blocks of Objects
+		size_t				objectsInLastBlock;	// the number of Objects constructed in the last block of Objects
+
+		bool										objectsDestroyed;	// whether or not the Objects have been destroyed yet
+		vector<unique_ptr<objectArena>>	adoptedArenas;		// arenas whose Objects have been added to this arena's tree
+		vector<shared_ptr<void>>			keptResources;		// things the Objects refer to that must outlive them
+};
+
+
+// Lets the containers inside an Object take their memory from the arena that Object lives in.
+// Objects that aren't in an arena use the normal heap.
+template <typename T>
+class arenaAllocator
+{
+	public:
+		typedef T value_type;
+		typedef true_type propagate_on_container_move_assignment;	// so an Object can take over a list built in another arena
+
+		arenaAllocator(objectArena* _arena = nullptr): arena(_arena) {}
+		template <typename U>
+		arenaAllocator(const arenaAllocator<U>& other): arena(other.getArena()) {}
+
+		T* allocate(size_t n)
+		{
+			if (arena != nullptr)
+			{
+				return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+			}
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+		void deallocate(T* p, size_t)
+		{
+			if (arena == nullptr)
+			{
+				::operator delete(p);
+			}
+		}
+
+		objectArena* getArena() const { return arena; }
+
+	private:
+		objectArena* arena;	// the arena to allocate from, or nullptr for the heap
+};
+
+template <typename T, typename U>
+bool operator==(const arenaAllocator<T>& lhs, const arenaAllocator<U>& rhs)
+{
+	return lhs.getArena() == rhs.getArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const arenaAllocator<T>& lhs, const arenaAllocator<U>& rhs)
+{
+	return lhs.getArena() != rhs.getArena();
+}
+
+
+
+#endif // OBJECT_ARENA_H_
@@ -0,0 +1,573 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#include "ParadoxParserCore.h"
+#include "ParadoxParserLexer.h"
+#include "ParadoxParserVisitor.h"
+#include "Log.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+
+
+namespace parser_core
+{
+	static const ptrdiff_t lazyThreshold = 4096;	// objects smaller than this are cheaper to parse straight away than to come back to
+
+
+	// Builds Objects from the events of an eventReader
+	class treeBuilder: public parseVisitor, public readerHooks
+	{
+		public:
+			treeBuilder(const char* begin, const char* end, sourceEncoding encoding, objectArena* _arena, bool isFragment = false, lazySource* _lazy = nullptr):
+				reader(begin, end, encoding, *this, this),
+				arena(_arena),
+				lazy(_lazy),
+				openBlocks(),
+				openObject(nullptr)
+			{
+				if (isFragment)
+				{
+					reader.setFragment();
+				}
+				if (lazy != nullptr)
+				{
+					reader.setSkipThreshold(lazyThreshold);
+				}
+			}
+
+			bool build(Object* topLevel);
+			// Parses the contents of one object, up to and including its closing brace, into target.
+			bool buildObject(Object* target);
+			// Parses the rest of an object that an earlier fragment started into continued, then everything after it into topLevel.
+			bool buildContinuation(Object* continued, Object* topLevel);
+
+			Object* getOpenObject() const { return openObject; }
+
+			void scalar(const string& key, const string& value);
+			void list(const vector<string>& values);
+			void beginBlock(const string& key);
+			void endBlock();
+			void warning(const string& message);
+
+			void beginAnonymousBlock();
+			void skippedBlock(const string& key, const char* bodyBegin, const char* bodyEnd);
+			void textRanOut();
+
+		private:
+			struct openBlock
+			{
+				Object*	object;		// the object being filled
+				bool		anonymous;	// whether the object had no key in the text
+			};
+
+			Object* newObject(const string& key);
+			Object* getParent() const { return openBlocks.back().object; }
+
+			eventReader								reader;			// the events being built from
+			objectArena*								arena;			// where the new objects are allocated
+			lazySource*								lazy;				// the lazy parse this is part of, if big objects are to be left unparsed
+			vector<openBlock>						openBlocks;		// the objects being filled, outermost first. The first is the one the parse was asked to fill.
+			Object*									openObject;		// the outermost object that was still open when a fragment ran out
+	};
+
+	bool treeBuilder::build(Object* topLevel)
+	{
+		openBlocks.assign(1, openBlock{ topLevel, false });
+		return reader.read();
+	}
+
+
+	bool treeBuilder::buildObject(Object* target)
+	{
+		openBlocks.assign(1, openBlock{ target, false });
+		return reader.readObject(target->getKey());
+	}
+
+
+	bool treeBuilder::buildContinuation(Object* continued, Object* topLevel)
+	{
+		buildObject(continued);
+		return build(topLevel);
+	}
+
+
+	void treeBuilder::scalar(const string& key, const string& value)
+	{
+		Object* assignment = newObject(key);	// the object holding the value
+		assignment->setValue(value);
+		getParent()->setValue(assignment);
+	}
+
+
+	void treeBuilder::list(const vector<string>& values)
+	{
+		getParent()->addToList(values.begin(), values.end());
+	}
+
+
+	void treeBuilder::beginBlock(const string& key)
+	{
+		openBlocks.push_back(openBlock{ newObject(key), false });
+	}
+
+
+	void treeBuilder::endBlock()
+	{
+		openBlock finished = openBlocks.back();	// the object that has just ended
+		openBlocks.pop_back();
+		if (finished.anonymous && finished.object->getLeaves().empty() && (finished.object->numTokens() == 0))
+		{
+			// stray empty braces are dropped
+			return;
+		}
+		getParent()->setValue(finished.object);
+	}
+
+
+	void treeBuilder::warning(const string& message)
+	{
+		LOG(LogLevel::Warning) << message;
+	}
+
+
+	void treeBuilder::beginAnonymousBlock()
+	{
+		static const unsigned int objlistSymbol = objectKeys::intern("objlist");
+		openBlocks.push_back(openBlock{ arena->newObject(objlistSymbol), true });
+	}
+
+
+	void treeBuilder::skippedBlock(const string& key, const char* bodyBegin, const char* bodyEnd)
+	{
+		lazyBody* body = static_cast<lazyBody*>(arena->allocate(sizeof(lazyBody), alignof(lazyBody)));	// where the contents are, for later
+		body->begin = bodyBegin;
+		body->end = bodyEnd;
+		body->source = lazy;
+
+		Object* skipped = newObject(key);	// the object that will parse its contents when it's first looked at
+		skipped->setLazyBody(body);
+		getParent()->setValue(skipped);
+	}
+
+
+	void treeBuilder::textRanOut()
+	{
+		// the outer objects hear about it after the inner ones, so the outermost is kept
+		openObject = getParent();
+	}
+
+
+	Object* treeBuilder::newObject(const string& key)
+	{
+		return arena->newObject(objectKeys::intern(key));
+	}
+
+
+	// One piece of a file that is being parsed in parallel
+	struct chunk
+	{
+		chunk(const char* _begin, const char* _end, bool _continues):
+			begin(_begin),
+			end(_end),
+			continues(_continues),
+			arena(),
+			root(nullptr),
+			continuation(nullptr),
+			openObject(nullptr),
+			valid(true)
+		{}
+
+		const char*					begin;			// the start of the chunk's text
+		const char*					end;				// the end of the chunk's text
+		bool							continues;		// whether the chunk starts partway through the previous chunk's open object
+		unique_ptr<objectArena>	arena;			// where the chunk's objects are allocated
+		Object*						root;				// the top-level objects that start in this chunk
+		Object*						continuation;	// the rest of the previous chunk's open object, if this chunk continues it
+		Object*						openObject;		// the object still open at the end of the chunk, if any
+		bool							valid;			// whether or not the chunk was well-formed
+	};
+
+
+	// A place the text can be split into chunks
+	struct boundary
+	{
+		const char*	position;		// the start of the next chunk
+		bool			insideObject;	// whether the split is inside a top-level object, rather than between two
+	};
+
+
+	// The state of a brace scan at some point in the text
+	struct scanState
+	{
+		int	depth;			// the number of objects open, relative to where the scan started
+		bool	inQuote;			// whether the scan is inside a quoted string
+		bool	unbalanced;		// whether a '}' has closed more objects than were open
+	};
+
+
+	static const ptrdiff_t minimumChunkSize = 1 << 20;	// smaller chunks than this aren't worth handing to another thread
+	static const unsigned int chunksPerThread = 4;			// there are more chunks than threads, so that uneven chunks even out
+
+
+	// Tracks the braces in [begin, end) without a full lexer, skipping quoted strings and comments as the lexer does.
+	// If boundaries is given, records where the text can be split: just after a '}' that closes a top-level object, or an object directly inside
+	// a top-level object, at least chunkSize after the previous split. The second kind lets the few huge top-level objects in saves, such as
+	// provinces and countries, be split as well.
+	static scanState scanText(const char* begin, const char* end, scanState state, ptrdiff_t chunkSize, vector<boundary>* boundaries)
+	{
+		const char* lastSplit = begin;	// where the chunk being measured starts
+		const char* pos = begin;			// the current position in the text
+		while (pos < end)
+		{
+			if (state.inQuote)
+			{
+				const char* closingQuote = static_cast<const char*>(memchr(pos, '"', end - pos));	// the end of the quoted string
+				if (closingQuote == nullptr)
+				{
+					break;
+				}
+				pos = closingQuote + 1;
+				state.inQuote = false;
+				continue;
+			}
+
+			while ((pos < end) && !scanTable.stops[static_cast<unsigned char>(*pos)])
+			{
+				++pos;
+			}
+			if (pos == end)
+			{
+				break;
+			}
+
+			switch (*pos)
+			{
+				case '"':
+					state.inQuote = true;
+					break;
+
+				case '#':
+				{
+					const char* lineEnd = static_cast<const char*>(memchr(pos, '\n', end - pos));	// the end of the comment
+					pos = (lineEnd != nullptr) ? lineEnd : (end - 1);
+					break;
+				}
+
+				case '{':
+					state.depth++;
+					break;
+
+				case '}':
+					state.depth--;
+					if (state.depth < 0)
+					{
+						state.unbalanced = true;
+					}
+					else if ((boundaries != nullptr) && (state.depth <= 1) && ((pos + 1 - lastSplit) >= chunkSize))
+					{
+						boundary split = { pos + 1, (state.depth == 1) };	// the place to split
+						boundaries->push_back(split);
+						lastSplit = pos + 1;
+					}
+					break;
+			}
+			++pos;
+		}
+
+		return state;
+	}
+
+
+	// Runs work(0) through work(numThreads - 1) at the same time, the first on this thread and the rest on new ones
+	static void runOnThreads(unsigned int numThreads, const function<void(unsigned int)>& work)
+	{
+		vector<thread> workers;	// the extra threads
+		for (unsigned int i = 1; i < numThreads; i++)
+		{
+			workers.push_back(thread(work, i));
+		}
+		work(0);
+		for (auto& worker: workers)
+		{
+			worker.join();
+		}
+	}
+
+
+	// Splits the text into chunks that can be parsed independently. Both passes over the text are themselves split across the threads:
+	// the first finds how the depth changes over each thread's range, so that the second can find the boundaries knowing the true depth.
+	// Returns false if the braces don't balance or the text ends inside a quoted string, in which case the text should be parsed serially so that
+	// the problems are reported as usual.
+	static bool findChunks(const char* begin, const char* end, unsigned int numThreads, ptrdiff_t chunkSize, vector<chunk>& chunks)
+	{
+		// each range starts at the beginning of a line, where the scan can't be inside a comment, and almost never is inside a quote
+		vector<const char*> rangeStarts;	// the start of each thread's range, followed by the end of the text
+		rangeStarts.push_back(begin);
+		for (unsigned int i = 1; i < numThreads; i++)
+		{
+			const char* nominalStart = max(rangeStarts.back(), begin + (end - begin) / numThreads * i);	// an even split, which may be mid-line
+			const char* lineEnd = static_cast<const char*>(memchr(nominalStart, '\n', end - nominalStart));	// the end of that line
+			rangeStarts.push_back((lineEnd != nullptr) ? (lineEnd + 1) : end);
+		}
+		rangeStarts.push_back(end);
+
+		const scanState startOfRange = { 0, false, false };	// the state each range is first assumed to start in
+		vector<scanState> changes(numThreads);	// the change in depth over each range, and whether it ends inside a quote
+		runOnThreads(numThreads, [&](unsigned int i)
+		{
+			changes[i] = scanText(rangeStarts[i], rangeStarts[i + 1], startOfRange, chunkSize, nullptr);
+		});
+
+		vector<scanState> startStates(numThreads);	// the true state at the start of each range
+		scanState state = startOfRange;					// the true state at the start of the current range
+		for (unsigned int i = 0; i < numThreads; i++)
+		{
+			startStates[i] = state;
+			if (state.inQuote)
+			{
+				// a quoted string runs over the start of this range, so it has to be scanned again knowing that
+				scanState quoted = { 0, true, false };
+				changes[i] = scanText(rangeStarts[i], rangeStarts[i + 1], quoted, chunkSize, nullptr);
+			}
+			state.depth += changes[i].depth;
+			state.inQuote = changes[i].inQuote;
+		}
+		if ((state.depth != 0) || state.inQuote)
+		{
+			// the text ends inside an object or a quoted string
+			return false;
+		}
+
+		vector<vector<boundary>> boundaries(numThreads);	// the places each range can be split
+		vector<char> unbalanced(numThreads, false);			// whether each range closes more objects than are open
+		runOnThreads(numThreads, [&](unsigned int i)
+		{
+			unbalanced[i] = scanText(rangeStarts[i], rangeStarts[i + 1], startStates[i], chunkSize, &boundaries[i]).unbalanced;
+		});
+		if (find(unbalanced.begin(), unbalanced.end(), true) != unbalanced.end())
+		{
+			return false;
+		}
+
+		const char* chunkStart = begin;	// the start of the next chunk
+		bool continues = false;				// whether the next chunk starts inside an object
+		for (auto& rangeBoundaries: boundaries)
+		{
+			for (auto& split: rangeBoundaries)
+			{
+				chunks.emplace_back(chunkStart, split.position, continues);
+				chunkStart = split.position;
+				continues = split.insideObject;
+			}
+		}
+		chunks.emplace_back(chunkStart, end, continues);
+
+		return true;
+	}
+
+
+	static void parseChunk(chunk& piece, sourceEncoding encoding)
+	{
+		static const unsigned int topLevelSymbol = objectKeys::intern("topLevel");
+		piece.arena.reset(new objectArena);
+		piece.root = piece.arena->newObject(topLevelSymbol);
+
+		treeBuilder builder(piece.begin, piece.end, encoding, piece.arena.get(), true);
+		if (piece.continues)
+		{
+			piece.continuation = piece.arena->newObject(topLevelSymbol);
+			piece.valid = builder.buildContinuation(piece.continuation, piece.root);
+		}
+		else
+		{
+			piece.valid = builder.build(piece.root);
+		}
+		piece.openObject = builder.getOpenObject();
+	}
+
+
+	static void moveContents(Object* from, Object* to)
+	{
+		for (auto child: from->getLeaves())
+		{
+			to->setValue(child);
+		}
+		if (from->numTokens() > 0)
+		{
+			vector<string> tokens = from->getTokens();	// any anonymous values
+			to->addToList(tokens.begin(), tokens.end());
+		}
+	}
+
+
+	// Puts the chunks' objects into topLevel in the order of the text, and hands it their arenas.
+	static bool stitchChunks(vector<chunk>& chunks, Object* topLevel)
+	{
+		bool valid = true;					// whether or not every chunk was well-formed
+		Object* openObject = nullptr;		// the object the next chunk may continue
+		for (auto& piece: chunks)
+		{
+			valid = valid && piece.valid;
+			if ((piece.continuation != nullptr) && (openObject != nullptr))
+			{
+				moveContents(piece.continuation, openObject);
+			}
+			moveContents(piece.root, topLevel);
+
+			// a chunk that ends inside the object it continues leaves that object open for the next chunk
+			if ((piece.continuation == nullptr) || (piece.openObject != piece.continuation))
+			{
+				openObject = piece.openObject;
+			}
+			topLevel->getArena()->adopt(move(piece.arena));
+		}
+
+		return valid;
+	}
+
+
+	static bool parseInParallel(const char* begin, const char* end, sourceEncoding encoding, Object* topLevel)
+	{
+		unsigned int numThreads = thread::hardware_concurrency();	// the number of threads to parse with
+		vector<chunk> chunks;	// the pieces of the text
+		if ((numThreads > 1) && ((end - begin) >= 2 * minimumChunkSize))
+		{
+			ptrdiff_t chunkSize = max(minimumChunkSize, (end - begin) / static_cast<ptrdiff_t>(numThreads * chunksPerThread));	// the size to split the text into
+			if (!findChunks(begin, end, numThreads, chunkSize, chunks))
+			{
+				chunks.clear();
+			}
+		}
+		if (chunks.size() < 2)
+		{
+			treeBuilder builder(begin, end, encoding, topLevel->getArena());
+			return builder.build(topLevel);
+		}
+
+		atomic<size_t> nextChunk(0);	// the first chunk no thread has started on
+		runOnThreads(numThreads, [&](unsigned int)
+		{
+			for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++)
+			{
+				parseChunk(chunks[i], encoding);
+			}
+		});
+
+		return stitchChunks(chunks, topLevel);
+	}
+
+
+	// Everything needed to parse the rest of a lazy parse later. The top level object's arena keeps it alive.
+	struct lazySource
+	{
+		lazySource(sourceEncoding _encoding, objectArena* _rootArena): encoding(_encoding), rootArena(_rootArena), arenasLock(), threadArenas() {}
+
+		objectArena* getThreadArena();
+
+		sourceEncoding							encoding;		// the encoding of the text
+		objectArena*							rootArena;		// the top level object's arena, which owns the others
+		mutex										arenasLock;		// guards threadArenas and adding arenas to rootArena
+		map<thread::id, objectArena*>		threadArenas;	// the arena each thread puts the Objects it parses into
+	};
+
+
+	objectArena* lazySource::getThreadArena()
+	{
+		lock_guard<mutex> guard(arenasLock);
+		auto existing = threadArenas.find(this_thread::get_id());
+		if (existing != threadArenas.end())
+		{
+			return existing->second;
+		}
+
+		unique_ptr<objectArena> newArena(new objectArena);	// an arena for this thread
+		objectArena* arena = newArena.get();
+		rootArena->adopt(move(newArena));
+		threadArenas.insert(make_pair(this_thread::get_id(), arena));
+		return arena;
+	}
+
+
+	Object* parseLazyBody(const lazyBody& body, unsigned int keySymbol)
+	{
+		objectArena* arena = body.source->getThreadArena();	// where the sub-objects go
+		Object* parsed = arena->newObject(keySymbol);
+		treeBuilder builder(body.begin, body.end, body.source->encoding, arena, false, body.source);
+		builder.buildObject(parsed);
+		return parsed;
+	}
+
+
+	bool parseBuffer(const char* begin, const char* end, sourceEncoding encoding, Object* topLevel, parseMode mode)
+	{
+		if (mode == parseMode::parallel)
+		{
+			return parseInParallel(begin, end, encoding, topLevel);
+		}
+		else if (mode == parseMode::lazy)
+		{
+			lazySource* source = new lazySource(encoding, topLevel->getArena());	// the settings for parsing the rest later
+			topLevel->getArena()->keep(shared_ptr<void>(source));
+			treeBuilder builder(begin, end, encoding, topLevel->getArena(), false, source);
+			return builder.build(topLevel);
+		}
+
+		treeBuilder builder(begin, end, encoding, topLevel->getArena());
+		return builder.build(topLevel);
+	}
+
+
+	void visitContents(Object* obj, parseVisitor& visitor)
+	{
+		const lazyBody* body = obj->getLazyBody();	// the object's unparsed text, if it has any
+		if ((body != nullptr) && (body->source != nullptr))
+		{
+			parseObjectEvents(body->begin, body->end, body->source->encoding, obj->getKey(), visitor);
+			return;
+		}
+
+		for (auto child: obj->getLeaves())
+		{
+			if (child->isLeaf())
+			{
+				visitor.scalar(child->getKey(), child->getLeaf());
+			}
+			else
+			{
+				visitor.beginBlock(child->getKey());
+				visitContents(child, visitor);
+				visitor.endBlock();
+			}
+		}
+		if (obj->numTokens() > 0)
+		{
+			visitor.list(obj->getTokens());
+		}
+	}
+} // namespace parser_core
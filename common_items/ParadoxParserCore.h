@@ -0,0 +1,74 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef PARADOX_PARSER_CORE_H_
+#define PARADOX_PARSER_CORE_H_
+
+
+
+#include "Object.h"
+#include "ParadoxParserEvents.h"
+#include <string>
+using namespace std;
+
+
+
+// A byte-level lexer and parser for Paradox script, shared by parser_8859_15 and parser_UTF8.
+// It builds the Object tree directly from the raw file contents, without any intermediate wide strings.
+namespace parser_core
+{
+	enum class parseMode
+	{
+		serial,		// the text is parsed from start to finish on the calling thread
+		parallel,	// the text is split into pieces at top-level boundaries, and the pieces are parsed on several threads
+		lazy			// big objects are only skipped over, and their contents are parsed the first time they're looked at
+	};
+
+	struct lazySource;
+
+	// The unparsed text of an Object's sub-objects, from a lazy parse
+	struct lazyBody
+	{
+		const char*	begin;	// the first character after the opening brace
+		const char*	end;		// one past the closing brace
+		lazySource*	source;	// the parse the text is from
+	};
+
+	// Parses the text in [begin, end) and adds the resulting objects to topLevel, allocating them in topLevel's arena.
+	// Returns false if the text was malformed, in which case topLevel holds as much as could be recovered.
+	// All of the state for a parse is local to it, so several files may be parsed at once.
+	// In lazy mode the text must stay valid for as long as topLevel does.
+	bool parseBuffer(const char* begin, const char* end, sourceEncoding encoding, Object* topLevel, parseMode mode = parseMode::serial);
+
+	// Parses the sub-objects of an Object from a lazy parse into a new Object, in an arena that only the calling thread adds to.
+	// Any big objects among them are left lazy in turn.
+	Object* parseLazyBody(const lazyBody& body, unsigned int keySymbol);
+
+	// Sends the contents of obj to visitor as events. If obj is from a lazy parse and hasn't been looked at yet, its text is read directly and
+	// it stays unparsed, so that a big object can be gone through one part at a time.
+	void visitContents(Object* obj, parseVisitor& visitor);
+}
+
+
+
+#endif // PARADOX_PARSER_CORE_H_
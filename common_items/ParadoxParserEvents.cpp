@@ -0,0 +1,240 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#include "ParadoxParserEvents.h"
+#include "ParadoxParserLexer.h"
+
+
+
+namespace parser_core
+{
+	bool eventReader::read()
+	{
+		readBody("topLevel", true);
+		return valid;
+	}
+
+
+	bool eventReader::readObject(const string& key)
+	{
+		readBody(key, false);
+		return valid;
+	}
+
+
+	void eventReader::readBody(const string& key, bool isTopLevel)
+	{
+		vector<string> listItems;	// any anonymous values, which make this a list
+		while (true)
+		{
+			token tok = source.next();	// the token under consideration
+			if (tok.type == tokenType::end)
+			{
+				if (!isTopLevel && isFragment)
+				{
+					// the object carries on in the next fragment
+					hooks->textRanOut();
+				}
+				else if (!isTopLevel)
+				{
+					visitor.warning("Unexpected end of file while parsing " + key);
+					valid = false;
+				}
+				break;
+			}
+			else if (tok.type == tokenType::close)
+			{
+				if (!isTopLevel)
+				{
+					break;
+				}
+				visitor.warning("Ignoring unmatched '}' at the top level");
+				valid = false;
+			}
+			else if (tok.type == tokenType::open)
+			{
+				// an anonymous object, as in objlist = { { leaf = "string" } { leaf = leaf } }
+				if (hooks != nullptr)
+				{
+					hooks->beginAnonymousBlock();
+				}
+				else
+				{
+					visitor.beginBlock("objlist");
+				}
+				readBody("objlist", false);
+				visitor.endBlock();
+			}
+			else if (tok.type == tokenType::assign)
+			{
+				// an assignment without a left-hand side
+				readValue("epsilon");
+			}
+			else
+			{
+				const token& following = source.peek();	// the token after this one
+				if (following.type == tokenType::assign)
+				{
+					source.next();
+					readValue(tokenText(tok, encoding));
+				}
+				else if ((following.type == tokenType::open) && (tok.type == tokenType::word))
+				{
+					// an object without the equals sign, as in color { 1 2 3 }
+					readValue(tokenText(tok, encoding));
+				}
+				else if (!isTopLevel)
+				{
+					listItems.push_back(tokenText(tok, encoding));
+				}
+				else if (!isFileHeader(tok))
+				{
+					visitor.warning("Ignoring unexpected text at the top level: " + tokenText(tok, encoding));
+					valid = false;
+				}
+			}
+		}
+
+		if (!listItems.empty())
+		{
+			visitor.list(listItems);
+		}
+	}
+
+
+	void eventReader::readValue(const string& key)
+	{
+		token tok = source.next();	// the value token
+		switch (tok.type)
+		{
+			case tokenType::word:
+			case tokenType::quoted:
+				visitor.scalar(key, tokenText(tok, encoding));
+				break;
+
+			case tokenType::open:
+				readBlock(key);
+				break;
+
+			default:
+				visitor.warning("Missing value for " + key);
+				visitor.scalar(key, "");
+				source.putBack(tok);
+				valid = false;
+				break;
+		}
+	}
+
+
+	void eventReader::readBlock(const string& key)
+	{
+		if (skipThreshold > 0)
+		{
+			const char* bodyBegin = source.getPosition();	// the start of the object's contents
+			const char* bodyEnd = source.skipObject();		// the end of the object's contents
+			if ((bodyEnd - bodyBegin) >= skipThreshold)
+			{
+				hooks->skippedBlock(key, bodyBegin, bodyEnd);
+				return;
+			}
+
+			// small objects are read straight away, and so is everything inside them
+			source.seek(bodyBegin);
+			ptrdiff_t outerThreshold = skipThreshold;	// the threshold to return to after this object
+			skipThreshold = 0;
+			readBlock(key);
+			skipThreshold = outerThreshold;
+			return;
+		}
+
+		visitor.beginBlock(key);
+		readBody(key, false);
+		visitor.endBlock();
+	}
+
+
+	bool parseEvents(const char* begin, const char* end, sourceEncoding encoding, parseVisitor& visitor)
+	{
+		eventReader reader(begin, end, encoding, visitor);
+		return reader.read();
+	}
+
+
+	bool parseObjectEvents(const char* begin, const char* end, sourceEncoding encoding, const string& key, parseVisitor& visitor)
+	{
+		eventReader reader(begin, end, encoding, visitor);
+		return reader.readObject(key);
+	}
+
+
+	string convert8859_15ToUTF8(const char* begin, const char* end)
+	{
+		const char* pos = begin;	// the current position in the text
+		while ((pos < end) && !(*pos & 0x80))
+		{
+			++pos;
+		}
+		if (pos == end)
+		{
+			return string(begin, end);
+		}
+
+		string converted(begin, pos);	// the UTF-8 text
+		converted.reserve((end - begin) + (end - pos));
+		for (; pos < end; ++pos)
+		{
+			const unsigned char c = static_cast<unsigned char>(*pos);
+			unsigned int codePoint = c;	// the unicode value of this character
+			switch (c)
+			{
+				// these are the only places where 8859-15 differs from 8859-1
+				case 0xA4: codePoint = 0x20AC;	break;	// euro sign
+				case 0xA6: codePoint = 0x0160;	break;	// S with caron
+				case 0xA8: codePoint = 0x0161;	break;	// s with caron
+				case 0xB4: codePoint = 0x017D;	break;	// Z with caron
+				case 0xB8: codePoint = 0x017E;	break;	// z with caron
+				case 0xBC: codePoint = 0x0152;	break;	// OE ligature
+				case 0xBD: codePoint = 0x0153;	break;	// oe ligature
+				case 0xBE: codePoint = 0x0178;	break;	// Y with diaeresis
+			}
+
+			if (codePoint < 0x80)
+			{
+				converted += static_cast<char>(codePoint);
+			}
+			else if (codePoint < 0x800)
+			{
+				converted += static_cast<char>(0xC0 | (codePoint >> 6));
+				converted += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else
+			{
+				converted += static_cast<char>(0xE0 | (codePoint >> 12));
+				converted += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				converted += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+		}
+
+		return converted;
+	}
+} // namespace parser_core
@@ -0,0 +1,80 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef PARADOX_PARSER_EVENTS_H_
+#define PARADOX_PARSER_EVENTS_H_
+
+
+
+#include <string>
+#include <vector>
+using namespace std;
+
+
+
+// The core of the Paradox script parser, which reads text as a stream of events. It doesn't depend on Object or the log,
+// so converters with their own Object classes can build them from it as well. The Object parser is in ParadoxParserCore.h.
+namespace parser_core
+{
+	enum class sourceEncoding
+	{
+		UTF8,			// the text is already UTF-8 and is copied as-is
+		ISO8859_15	// the text is 8859-15 and is converted to UTF-8 as it is read
+	};
+
+
+	// Receives Paradox script as a stream of events, in the order of the text, instead of as an Object tree.
+	// Anonymous objects have the key objlist and assignments without a left-hand side have the key epsilon, as in the Object tree.
+	class parseVisitor
+	{
+		public:
+			virtual ~parseVisitor() {}
+
+			// key = value
+			virtual void scalar(const string& key, const string& value) = 0;
+			// The anonymous values in the current object, as in key = { 1 2 3 }. They are given just before the object ends.
+			virtual void list(const vector<string>& values) = 0;
+			// key = {
+			virtual void beginBlock(const string& key) = 0;
+			// }
+			virtual void endBlock() = 0;
+			// Something in the text that had to be skipped or guessed at
+			virtual void warning(const string& message) = 0;
+	};
+
+
+	// Reads the text in [begin, end) as a stream of events, without building any Objects.
+	// Returns false if the text was malformed.
+	bool parseEvents(const char* begin, const char* end, sourceEncoding encoding, parseVisitor& visitor);
+
+	// Reads the contents of the object called key, from just after its opening brace up to and including its closing brace.
+	// Returns false if the text was malformed.
+	bool parseObjectEvents(const char* begin, const char* end, sourceEncoding encoding, const string& key, parseVisitor& visitor);
+
+	// Converts a run of 8859-15 bytes to UTF-8.
+	string convert8859_15ToUTF8(const char* begin, const char* end);
+}
+
+
+
+#endif // PARADOX_PARSER_EVENTS_H_
@@ -0,0 +1,353 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef PARADOX_PARSER_LEXER_H_
+#define PARADOX_PARSER_LEXER_H_
+
+
+
+#include "ParadoxParserEvents.h"
+#include <cstddef>
+#include <string>
+using namespace std;
+
+
+
+// The tokenizer and event reader behind both the Object parser and the public event API. It's only meant for the parser's own source files.
+// The tokenizer is all inline so that it can be inlined into the reader's inner loop.
+namespace parser_core
+{
+	enum class tokenType
+	{
+		end,			// the end of the text
+		open,			// {
+		close,		// }
+		assign,		// =
+		quoted,		// a string in quotes. The quotes are not part of the token.
+		word			// an unquoted string
+	};
+
+	struct token
+	{
+		tokenType	type;		// what kind of token this is
+		const char*	begin;	// the first character of the token's text
+		const char*	end;		// one past the last character of the token's text
+	};
+
+
+	// The characters brace scans have to stop at
+	struct scanStops
+	{
+		scanStops(): stops()
+		{
+			stops['{'] = stops['}'] = stops['"'] = stops['#'] = true;
+		}
+
+		bool stops[256];	// whether or not the scan stops at each character
+	};
+	static const scanStops scanTable;
+
+
+	class lexer
+	{
+		public:
+			lexer(const char* _begin, const char* _end): pos(_begin), end(_end), hasPeeked(false), peeked() {}
+
+			token next();
+			const token& peek();
+			void putBack(const token& tok);
+
+			const char* getPosition() const { return pos; }
+			void seek(const char* position);
+			// Moves past the rest of an object whose opening brace has just been read, without making tokens of it.
+			// Returns the position just after the closing brace.
+			const char* skipObject();
+
+		private:
+			token scan();
+			void skipWhitespaceAndComments();
+
+			const char*	pos;			// the current position in the text
+			const char*	end;			// the end of the text
+			bool			hasPeeked;	// whether or not a token has been read ahead
+			token			peeked;		// the token that has been read ahead
+	};
+
+
+	static inline bool isWhitespace(const char c)
+	{
+		return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r') || (c == '\v') || (c == '\f');
+	}
+
+
+	static inline bool isDelimiter(const char c)
+	{
+		return isWhitespace(c) || (c == '{') || (c == '}') || (c == '=') || (c == '"') || (c == '#');
+	}
+
+
+	inline token lexer::next()
+	{
+		if (hasPeeked)
+		{
+			hasPeeked = false;
+			return peeked;
+		}
+		return scan();
+	}
+
+
+	inline const token& lexer::peek()
+	{
+		if (!hasPeeked)
+		{
+			peeked = scan();
+			hasPeeked = true;
+		}
+		return peeked;
+	}
+
+
+	inline void lexer::putBack(const token& tok)
+	{
+		peeked = tok;
+		hasPeeked = true;
+	}
+
+
+	inline void lexer::seek(const char* position)
+	{
+		pos = position;
+		hasPeeked = false;
+	}
+
+
+	inline const char* lexer::skipObject()
+	{
+		unsigned int depth = 1;	// the number of objects open
+		while (pos < end)
+		{
+			while ((pos < end) && !scanTable.stops[static_cast<unsigned char>(*pos)])
+			{
+				++pos;
+			}
+			if (pos == end)
+			{
+				break;
+			}
+
+			switch (*pos++)
+			{
+				case '"':
+					while ((pos < end) && (*pos != '"'))
+					{
+						++pos;
+					}
+					if (pos < end)
+					{
+						++pos;
+					}
+					break;
+
+				case '#':
+					while ((pos < end) && (*pos != '\n'))
+					{
+						++pos;
+					}
+					break;
+
+				case '{':
+					depth++;
+					break;
+
+				case '}':
+					if (--depth == 0)
+					{
+						return pos;
+					}
+					break;
+			}
+		}
+
+		return pos;
+	}
+
+
+	inline void lexer::skipWhitespaceAndComments()
+	{
+		while (pos < end)
+		{
+			if (isWhitespace(*pos))
+			{
+				++pos;
+			}
+			else if (*pos == '#')
+			{
+				while ((pos < end) && (*pos != '\n'))
+				{
+					++pos;
+				}
+			}
+			else
+			{
+				return;
+			}
+		}
+	}
+
+
+	inline token lexer::scan()
+	{
+		skipWhitespaceAndComments();
+		token tok;	// the token being read
+		tok.begin = pos;
+		if (pos == end)
+		{
+			tok.type = tokenType::end;
+			tok.end = pos;
+			return tok;
+		}
+
+		switch (*pos)
+		{
+			case '{':
+				tok.type = tokenType::open;
+				tok.end = ++pos;
+				break;
+
+			case '}':
+				tok.type = tokenType::close;
+				tok.end = ++pos;
+				break;
+
+			case '=':
+				tok.type = tokenType::assign;
+				tok.end = ++pos;
+				break;
+
+			case '"':
+				tok.type = tokenType::quoted;
+				tok.begin = ++pos;
+				while ((pos < end) && (*pos != '"'))
+				{
+					++pos;
+				}
+				tok.end = pos;
+				if (pos < end)
+				{
+					++pos;	// skip the closing quote
+				}
+				break;
+
+			default:
+				tok.type = tokenType::word;
+				while ((pos < end) && !isDelimiter(*pos))
+				{
+					++pos;
+				}
+				tok.end = pos;
+				break;
+		}
+
+		return tok;
+	}
+
+
+	inline string tokenText(const token& tok, sourceEncoding encoding)
+	{
+		if (encoding == sourceEncoding::ISO8859_15)
+		{
+			return convert8859_15ToUTF8(tok.begin, tok.end);
+		}
+		else
+		{
+			return string(tok.begin, tok.end);
+		}
+	}
+
+
+	// CK2txt, EU4txt, etc. start some saves, and are the only text expected outside of an assignment
+	inline bool isFileHeader(const token& tok)
+	{
+		return ((tok.end - tok.begin) > 3) && (string(tok.end - 3, tok.end) == "txt");
+	}
+
+
+	// The events that only a reader building Objects needs: telling anonymous objects apart from ones keyed objlist, leaving big objects
+	// unread, and reading a text in pieces.
+	class readerHooks
+	{
+		public:
+			virtual ~readerHooks() {}
+
+			// { with nothing before it. It ends with an endBlock, as other objects do.
+			virtual void beginAnonymousBlock() = 0;
+			// key = { ... } that was skipped over rather than read. The contents run from just after the opening brace to just after the closing one.
+			virtual void skippedBlock(const string& key, const char* bodyBegin, const char* bodyEnd) = 0;
+			// The text of a fragment ran out inside an object. Each object still open hears this in turn, innermost first, just before its endBlock.
+			virtual void textRanOut() = 0;
+	};
+
+
+	// Reads text into a stream of events for a parseVisitor. This is the only implementation of the grammar; the Object parser is a visitor of it.
+	class eventReader
+	{
+		public:
+			eventReader(const char* begin, const char* end, sourceEncoding _encoding, parseVisitor& _visitor, readerHooks* _hooks = nullptr):
+				source(begin, end),
+				encoding(_encoding),
+				visitor(_visitor),
+				hooks(_hooks),
+				valid(true),
+				isFragment(false),
+				skipThreshold(0)
+			{}
+
+			// Reads everything left in the text as top-level values.
+			bool read();
+			// Reads the contents of one object, up to and including its closing brace.
+			bool readObject(const string& key);
+
+			// The text is one piece of a larger text, so it may stop partway through an object without being malformed. Needs hooks.
+			void setFragment() { isFragment = true; }
+			// Objects whose contents are at least this long are skipped over and given to the hooks, rather than read. Needs hooks.
+			void setSkipThreshold(ptrdiff_t threshold) { skipThreshold = threshold; }
+
+		private:
+			void readBody(const string& key, bool isTopLevel);
+			void readValue(const string& key);
+			void readBlock(const string& key);
+
+			lexer				source;			// the tokens being read
+			sourceEncoding	encoding;		// the encoding of the source text
+			parseVisitor&	visitor;			// what the events go to
+			readerHooks*	hooks;			// what the extra events go to, if anything
+			bool				valid;			// whether or not the text has been well-formed so far
+			bool				isFragment;		// whether the text may stop partway through an object
+			ptrdiff_t		skipThreshold;	// the size from which objects are skipped rather than read, or zero to read everything
+	};
+}
+
+
+
+#endif // PARADOX_PARSER_LEXER_H_
@@ -50,6 +50,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 #include "Object.h"
+#include "ParadoxParserCore.h"
 #include <string>
 using namespace std;
 
@@ -57,10 +58,12 @@ using namespace std;
 
 namespace parser_UTF8
 {
-	Object*	getTopLevel();
-	void		clearStack(); 
-	void		initParser();
-	Object*	doParseFile(string filename);
+	// Parses a file into a new top level object, or returns nullptr if the file can't be opened.
+	// Big files such as saves are worth parsing in parallel, or lazily if only parts of them are read.
+	// Files parsed serially come from the parse cache when it's enabled and they haven't changed.
+	Object*	doParseFile(string filename, parser_core::parseMode mode = parser_core::parseMode::serial);
+	// Reads a file as a stream of events, without building any Objects. Returns false if the file can't be opened.
+	bool		visitFile(string filename, parser_core::parseVisitor& visitor);
 }
 
 
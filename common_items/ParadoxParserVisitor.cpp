@@ -0,0 +1,92 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#include "ParadoxParserVisitor.h"
+#include "Log.h"
+
+
+
+namespace parser_core
+{
+	void childStreamer::scalar(const string& key, const string& value)
+	{
+		if (objects.empty())
+		{
+			Object leaf(key);	// the top-level value
+			leaf.setValue(value);
+			handler(&leaf);
+			return;
+		}
+
+		Object* leaf = arena->newObject(key);	// the value
+		leaf->setValue(value);
+		objects.back()->setValue(leaf);
+	}
+
+
+	void childStreamer::list(const vector<string>& values)
+	{
+		if (!objects.empty())
+		{
+			objects.back()->addToList(values.begin(), values.end());
+		}
+	}
+
+
+	void childStreamer::beginBlock(const string& key)
+	{
+		if (objects.empty())
+		{
+			arena.reset(new objectArena);
+		}
+		objects.push_back(arena->newObject(key));
+	}
+
+
+	void childStreamer::endBlock()
+	{
+		if (objects.empty())
+		{
+			return;
+		}
+
+		Object* finished = objects.back();	// the object that has just ended
+		objects.pop_back();
+		if (objects.empty())
+		{
+			handler(finished);
+			arena.reset();
+		}
+		else if ((finished->getKey() != "objlist") || !finished->getLeaves().empty() || (finished->numTokens() > 0))
+		{
+			// stray empty braces are dropped, as when parsing into a tree
+			objects.back()->setValue(finished);
+		}
+	}
+
+
+	void childStreamer::warning(const string& message)
+	{
+		LOG(LogLevel::Warning) << message;
+	}
+}
@@ -0,0 +1,66 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef PARADOX_PARSER_VISITOR_H_
+#define PARADOX_PARSER_VISITOR_H_
+
+
+
+#include "Object.h"
+#include "ParadoxParserEvents.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std;
+
+
+
+namespace parser_core
+{
+	// Builds each top-level object of a stream into its own Object and hands it to a handler. The Object is deleted once the handler returns,
+	// so only one of them is in memory at a time, however big the whole stream is.
+	class childStreamer: public parseVisitor
+	{
+		public:
+			explicit childStreamer(function<void(Object*)> _handler): handler(_handler), arena(), objects() {}
+
+			void scalar(const string& key, const string& value);
+			void list(const vector<string>& values);
+			void beginBlock(const string& key);
+			void endBlock();
+			void warning(const string& message);
+
+		private:
+			childStreamer(const childStreamer&) = delete;
+			childStreamer& operator=(const childStreamer&) = delete;
+
+			function<void(Object*)>	handler;	// what to do with each object
+			unique_ptr<objectArena>	arena;		// where the current object is built, and released along with it
+			vector<Object*>			objects;	// the objects being built, from the top-level one inwards
+	};
+}
+
+
+
+#endif // PARADOX_PARSER_VISITOR_H_
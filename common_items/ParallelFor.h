@@ -0,0 +1,69 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef PARALLEL_FOR_H_
+#define PARALLEL_FOR_H_
+
+
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+
+namespace Utils
+{
+	// Calls work(i) for every i from 0 to count - 1, spread over the hardware threads. Items are handed out one at a time as threads finish
+	// their last one, so a thread that draws a few expensive items doesn't hold up the others. The calls may run in any order, so work must
+	// only change state belonging to its own item.
+	template<typename workFunction>
+	void parallelFor(size_t count, workFunction work)
+	{
+		size_t numThreads = std::min(count, static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())));	// the number of threads to work with
+		std::atomic<size_t> nextItem(0);	// the first item no thread has started on
+		auto worker = [&]()
+		{
+			for (size_t item = nextItem++; item < count; item = nextItem++)
+			{
+				work(item);
+			}
+		};
+
+		std::vector<std::thread> workers;	// the extra threads
+		for (size_t i = 1; i < numThreads; i++)
+		{
+			workers.push_back(std::thread(worker));
+		}
+		worker();
+		for (auto& thread: workers)
+		{
+			thread.join();
+		}
+	}
+}
+
+
+
+#endif // PARALLEL_FOR_H_
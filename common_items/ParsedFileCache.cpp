@@ -0,0 +1,468 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#include "ParsedFileCache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include "Log.h"
+
+
+
+namespace parser_cache
+{
+	// A cached file is laid out as:
+	//		the header - magic, formatVersion, encoding, and the size, modification time and contents hash of the text, then the text's path
+	//		the key table - the number of keys, then each key
+	//		the tree - the top-level object's contents, with each object written as its index in the key table, a node type, then
+	//					either the leaf value, or its children followed by its list tokens
+	// Numbers are written in the machine's own byte order, and strings as their length and then their bytes.
+	static const char				magic[8] = { 'P', 'G', 'C', 'T', 'R', 'E', 'E', '\0' };
+	static const unsigned int	formatVersion = 1;	// changes whenever the layout does, so that old caches are ignored
+	static const streamoff		modifiedTimeOffset = sizeof(magic) + 2 * sizeof(uint32_t) + sizeof(uint64_t);	// where the header keeps the text's modification time
+
+	enum nodeType: unsigned char
+	{
+		leafNode,	// key = value
+		blockNode	// key = { ... }
+	};
+
+
+	static string cacheFolder;	// where the cached files are kept, or empty if the cache is off
+
+
+	void enable(const string& folder)
+	{
+		if (!Utils::TryCreateFolder(folder))
+		{
+			LOG(LogLevel::Warning) << "Could not create the parse cache at " << folder << ", so every file will be parsed in full";
+			return;
+		}
+		cacheFolder = folder;
+	}
+
+
+	void disable()
+	{
+		cacheFolder.clear();
+	}
+
+
+	bool isEnabled()
+	{
+		return !cacheFolder.empty();
+	}
+
+
+	// A 64-bit FNV-1a hash
+	static uint64_t hashBytes(const char* begin, const char* end, uint64_t hash = 14695981039346656037ULL)
+	{
+		for (const char* current = begin; current < end; current++)
+		{
+			hash ^= static_cast<unsigned char>(*current);
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+
+	static string getCachePath(const string& filename, parser_core::sourceEncoding encoding)
+	{
+		const char encodingByte = static_cast<char>(encoding);	// the same file read as different encodings is cached separately
+		uint64_t nameHash = hashBytes(filename.data(), filename.data() + filename.size());
+		nameHash = hashBytes(&encodingByte, &encodingByte + 1, nameHash);
+
+		stringstream path;	// the path of the cached file
+		path << cacheFolder << "/" << hex << setw(16) << setfill('0') << nameHash << ".bin";
+		return path.str();
+	}
+
+
+	class treeWriter
+	{
+		public:
+			treeWriter(): keyIndices(), keys(), header(), tree() {}
+
+			void writeHeader(const string& filename, const Utils::mappedFile& file, parser_core::sourceEncoding encoding);
+			void writeContents(Object* obj);
+			string finish();
+
+		private:
+			void writeObject(Object* obj);
+			void writeString(string& buffer, const string& value);
+			template <typename T> void writeNumber(string& buffer, T value)
+			{
+				buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+			}
+
+			unordered_map<unsigned int, unsigned int>	keyIndices;	// the position in the key table of each key symbol
+			vector<unsigned int>							keys;			// the key table, as symbols
+			string											header;		// everything needed to tell whether the cache is still good
+			string											tree;			// the tree written so far
+	};
+
+
+	void treeWriter::writeHeader(const string& filename, const Utils::mappedFile& file, parser_core::sourceEncoding encoding)
+	{
+		header.append(magic, sizeof(magic));
+		writeNumber<uint32_t>(header, formatVersion);
+		writeNumber<uint32_t>(header, static_cast<uint32_t>(encoding));
+		writeNumber<uint64_t>(header, file.getSize());
+		writeNumber<uint64_t>(header, file.getModifiedTime());
+		writeNumber<uint64_t>(header, hashBytes(file.begin(), file.end()));
+		writeString(header, filename);
+	}
+
+
+	void treeWriter::writeContents(Object* obj)
+	{
+		vector<Object*> children = obj->getLeaves();	// the object's sub-objects
+		writeNumber<uint32_t>(tree, children.size());
+		for (auto child: children)
+		{
+			writeObject(child);
+		}
+
+		vector<string> tokens = obj->getTokens();	// the object's list items
+		writeNumber<uint32_t>(tree, tokens.size());
+		for (auto& token: tokens)
+		{
+			writeString(tree, token);
+		}
+	}
+
+
+	void treeWriter::writeObject(Object* obj)
+	{
+		auto index = keyIndices.insert(make_pair(obj->getKeySymbol(), static_cast<unsigned int>(keys.size())));	// the object's key in the key table
+		if (index.second)
+		{
+			keys.push_back(obj->getKeySymbol());
+		}
+		writeNumber<uint32_t>(tree, index.first->second);
+
+		if (obj->isLeaf())
+		{
+			writeNumber<unsigned char>(tree, leafNode);
+			writeString(tree, obj->getLeaf());
+		}
+		else
+		{
+			writeNumber<unsigned char>(tree, blockNode);
+			writeContents(obj);
+		}
+	}
+
+
+	void treeWriter::writeString(string& buffer, const string& value)
+	{
+		writeNumber<uint32_t>(buffer, value.size());
+		buffer.append(value);
+	}
+
+
+	string treeWriter::finish()
+	{
+		string contents = header;	// the whole cached file
+		writeNumber<uint32_t>(contents, keys.size());
+		for (auto symbol: keys)
+		{
+			writeString(contents, objectKeys::getKey(symbol));
+		}
+		contents.append(tree);
+		return contents;
+	}
+
+
+	// Reads a cached file, checking every length against the end of the file so that a damaged cache is only a miss.
+	class treeReader
+	{
+		public:
+			treeReader(const char* begin, const char* end): current(begin), last(end), valid(true), keys() {}
+
+			template <typename T> T readNumber()
+			{
+				T value = T();
+				if (static_cast<size_t>(last - current) < sizeof(T))
+				{
+					valid = false;
+					return value;
+				}
+				memcpy(&value, current, sizeof(T));
+				current += sizeof(T);
+				return value;
+			}
+			string readString();
+			bool readMagic();
+			void readKeys();
+			void readContents(Object* obj, objectArena* arena);
+
+			bool isValid() const { return valid; }
+			bool atEnd() const { return current == last; }
+
+		private:
+			Object* readObject(objectArena* arena);
+
+			const char*				current;	// the next byte to read
+			const char*				last;		// the end of the file
+			bool						valid;	// whether or not the file has made sense so far
+			vector<unsigned int>	keys;		// the key table, as symbols
+	};
+
+
+	string treeReader::readString()
+	{
+		uint32_t length = readNumber<uint32_t>();	// the length of the string
+		if (!valid || (static_cast<size_t>(last - current) < length))
+		{
+			valid = false;
+			return "";
+		}
+
+		string value(current, length);	// the string
+		current += length;
+		return value;
+	}
+
+
+	bool treeReader::readMagic()
+	{
+		if (static_cast<size_t>(last - current) < sizeof(magic) || (memcmp(current, magic, sizeof(magic)) != 0))
+		{
+			valid = false;
+			return false;
+		}
+		current += sizeof(magic);
+		return true;
+	}
+
+
+	void treeReader::readKeys()
+	{
+		uint32_t numKeys = readNumber<uint32_t>();	// the size of the key table
+		for (uint32_t i = 0; valid && (i < numKeys); i++)
+		{
+			keys.push_back(objectKeys::intern(readString()));
+		}
+	}
+
+
+	void treeReader::readContents(Object* obj, objectArena* arena)
+	{
+		uint32_t numChildren = readNumber<uint32_t>();	// the number of sub-objects
+		if (valid && (numChildren > 0))
+		{
+			// the sub-objects are gathered first, so that the object's list of them is allocated once at the right size
+			vector<Object*> children;	// the sub-objects
+			children.reserve(min<size_t>(numChildren, last - current));
+			for (uint32_t i = 0; valid && (i < numChildren); i++)
+			{
+				children.push_back(readObject(arena));
+			}
+			if (valid)
+			{
+				obj->setValue(children);
+			}
+		}
+
+		uint32_t numTokens = readNumber<uint32_t>();	// the number of list items
+		if (valid && (numTokens > 0))
+		{
+			vector<string> tokens;	// the list items
+			for (uint32_t i = 0; valid && (i < numTokens); i++)
+			{
+				tokens.push_back(readString());
+			}
+			obj->addToList(tokens.begin(), tokens.end());
+		}
+	}
+
+
+	Object* treeReader::readObject(objectArena* arena)
+	{
+		uint32_t keyIndex = readNumber<uint32_t>();	// the object's key in the key table
+		unsigned char type = readNumber<unsigned char>();	// what sort of object it is
+		if (!valid || (keyIndex >= keys.size()))
+		{
+			valid = false;
+			return nullptr;
+		}
+
+		Object* obj = arena->newObject(keys[keyIndex]);	// the object being read
+		if (type == leafNode)
+		{
+			obj->setValue(readString());
+		}
+		else if (type == blockNode)
+		{
+			readContents(obj, arena);
+		}
+		else
+		{
+			valid = false;
+		}
+		return obj;
+	}
+
+
+	// Reads the cached tree of the text into topLevel, if the cache is still good. timeIsStale is set if the text was written to since it was
+	// cached, but didn't change.
+	static bool readCache(const string& cachePath, const string& filename, const Utils::mappedFile& file, parser_core::sourceEncoding encoding, Object* topLevel, bool& timeIsStale)
+	{
+		Utils::mappedFile cached(cachePath);	// the cached tree
+		if (!cached.isOpen())
+		{
+			return false;
+		}
+
+		treeReader reader(cached.begin(), cached.end());
+		if (
+			!reader.readMagic() ||
+			(reader.readNumber<uint32_t>() != formatVersion) ||
+			(reader.readNumber<uint32_t>() != static_cast<uint32_t>(encoding)) ||
+			(reader.readNumber<uint64_t>() != file.getSize())
+			)
+		{
+			return false;
+		}
+		uint64_t modifiedTime = reader.readNumber<uint64_t>();	// when the text was last written, as of the caching
+		uint64_t contentsHash = reader.readNumber<uint64_t>();	// the hash of the text
+		if (!reader.isValid() || (reader.readString() != filename))
+		{
+			return false;
+		}
+		if (modifiedTime != file.getModifiedTime())
+		{
+			if (contentsHash != hashBytes(file.begin(), file.end()))
+			{
+				return false;
+			}
+			timeIsStale = true;
+		}
+
+		// the tree is read into a scratch object first, so that a damaged cache doesn't leave anything half-read in topLevel
+		reader.readKeys();
+		Object* contents = topLevel->getArena()->newObject(topLevel->getKeySymbol());	// the cached top-level contents
+		reader.readContents(contents, topLevel->getArena());
+		if (!reader.isValid() || !reader.atEnd())
+		{
+			LOG(LogLevel::Debug) << "Ignoring the damaged cache of " << filename;
+			return false;
+		}
+
+		for (auto child: contents->getLeaves())
+		{
+			topLevel->setValue(child);
+		}
+		if (contents->numTokens() > 0)
+		{
+			vector<string> tokens = contents->getTokens();	// the top-level list items
+			topLevel->addToList(tokens.begin(), tokens.end());
+		}
+		return true;
+	}
+
+
+	static void updateModifiedTime(const string& cachePath, uint64_t modifiedTime)
+	{
+		fstream cacheFile(cachePath, ios::in | ios::out | ios::binary);	// the cache, which is changed in place
+		if (!cacheFile.is_open())
+		{
+			return;
+		}
+		cacheFile.seekp(modifiedTimeOffset);
+		cacheFile.write(reinterpret_cast<const char*>(&modifiedTime), sizeof(modifiedTime));
+	}
+
+
+	bool load(const string& filename, const Utils::mappedFile& file, parser_core::sourceEncoding encoding, Object* topLevel)
+	{
+		if (!isEnabled())
+		{
+			return false;
+		}
+
+		string cachePath = getCachePath(filename, encoding);	// where the cache of this file is
+		bool timeIsStale = false;										// whether the text was touched without changing since it was cached
+		if (!readCache(cachePath, filename, file, encoding, topLevel, timeIsStale))
+		{
+			return false;
+		}
+
+		// the cache is brought up to date, so that later runs can trust the time again rather than hashing the whole text each time
+		if (timeIsStale)
+		{
+			updateModifiedTime(cachePath, file.getModifiedTime());
+		}
+		return true;
+	}
+
+
+	void store(const string& filename, const Utils::mappedFile& file, parser_core::sourceEncoding encoding, Object* topLevel)
+	{
+		if (!isEnabled())
+		{
+			return;
+		}
+
+		treeWriter writer;
+		writer.writeHeader(filename, file, encoding);
+		writer.writeContents(topLevel);
+
+		// the file is written under another name and then moved into place, so a reader never sees half of it. The name is unique to this
+		// store, so that other threads and converters caching the same file at the same time don't write over it.
+		static atomic<unsigned int> storeCount(0);				// the number of stores this run, to tell this process's stores apart
+		string cachePath = getCachePath(filename, encoding);	// where the cache of this file goes
+		string tempPath = cachePath + "." + to_string(Utils::getProcessID()) + "-" + to_string(storeCount++) + ".tmp";	// where it's written first
+		{
+			ofstream cacheFile(tempPath, ios::binary | ios::trunc);
+			if (!cacheFile.is_open())
+			{
+				LOG(LogLevel::Debug) << "Could not write the cache of " << filename << " to " << tempPath;
+				return;
+			}
+			string contents = writer.finish();
+			cacheFile.write(contents.data(), contents.size());
+			if (!cacheFile)
+			{
+				LOG(LogLevel::Debug) << "Could not write the cache of " << filename << " to " << tempPath;
+				cacheFile.close();
+				remove(tempPath.c_str());
+				return;
+			}
+		}
+
+		remove(cachePath.c_str());
+		if (rename(tempPath.c_str(), cachePath.c_str()) != 0)
+		{
+			LOG(LogLevel::Debug) << "Could not move the cache of " << filename << " into place at " << cachePath;
+			remove(tempPath.c_str());
+		}
+	}
+}
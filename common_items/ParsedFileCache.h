@@ -0,0 +1,57 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef PARSED_FILE_CACHE_H_
+#define PARSED_FILE_CACHE_H_
+
+
+
+#include "Object.h"
+#include "ParadoxParserCore.h"
+#include "OSCompatibilityLayer.h"
+#include <string>
+using namespace std;
+
+
+
+// A store of parsed files on disk, so that game files which haven't changed since the last run don't need parsing again.
+// Each file's Object tree is kept in a compact binary form, along with the size, modification time and contents hash of the text it came from.
+// The parsers use it for every file parsed in serial mode once it has been enabled. Saves are parsed lazily and are never cached.
+namespace parser_cache
+{
+	// Turns the cache on, keeping the cached files in folder. The cache is off until this is called.
+	void enable(const string& folder);
+	void disable();
+	bool isEnabled();
+
+	// Adds the cached contents of a file to topLevel. Returns false, leaving topLevel untouched, if the file isn't cached or has changed
+	// since it was. A file that has been touched but not changed still counts as cached.
+	bool load(const string& filename, const Utils::mappedFile& file, parser_core::sourceEncoding encoding, Object* topLevel);
+
+	// Saves the parsed contents of a file to the cache, replacing anything cached for it before.
+	void store(const string& filename, const Utils::mappedFile& file, parser_core::sourceEncoding encoding, Object* topLevel);
+}
+
+
+
+#endif // PARSED_FILE_CACHE_H_
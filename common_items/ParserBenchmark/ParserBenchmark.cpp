@@ -0,0 +1,439 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+// Times the Paradox parsers, Object lookups and serialisation over synthetic scripts and real save or game files, and reports the results as JSON.
+// Usage: ParserBenchmark [--iterations n] [--depth n] [--breadth n] [--list n] [--extended fraction] [--seed n] [--synthetic] [--output file] [file...]
+// A synthetic script is generated when no files are given, or when --synthetic is.
+
+#include "../Object.h"
+#include "../ParadoxParser8859_15.h"
+#include "../ParadoxParserUTF8.h"
+#include "../ParsedFileCache.h"
+#include "SyntheticScript.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+
+
+// Every allocation in the process is counted, so that a benchmark can report how many it made
+static atomic<uint64_t> allocationCount(0);	// how many allocations have been made
+static atomic<uint64_t> allocatedBytes(0);	// how many bytes have been asked for
+
+void* operator new(size_t size)
+{
+	allocationCount.fetch_add(1, memory_order_relaxed);
+	allocatedBytes.fetch_add(size, memory_order_relaxed);
+	void* memory = malloc(size == 0 ? 1 : size);
+	if (memory == nullptr)
+	{
+		throw bad_alloc();
+	}
+	return memory;
+}
+
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+
+void operator delete[](void* memory) noexcept
+{
+	operator delete(memory);
+}
+
+
+// The peak only ever rises over the life of the process, so a benchmark can only see how far it pushed the peak past where it was
+static uint64_t getPeakResidentBytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return 0;
+	}
+	return counters.PeakWorkingSetSize;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+#ifdef __APPLE__
+	return usage.ru_maxrss;
+#else
+	return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+
+
+struct benchmarkResult
+{
+	string name;	// what was timed
+	double seconds;	// the average time for one iteration
+	double megabytesPerSecond;	// how much of the source was got through each second
+	uint64_t operations;	// how many lookups or objects one iteration covers, or zero if that isn't meaningful
+	uint64_t allocations;	// the average number of allocations in one iteration
+	uint64_t allocatedBytes;	// the average number of bytes allocated in one iteration
+	uint64_t peakResidentGrowthBytes;	// how far the benchmark raised the process's peak resident memory, which is zero if earlier work peaked higher
+};
+
+
+struct fileResults
+{
+	string name;	// the file, or a description of the synthetic script
+	double megabytes;	// the size of the source
+	vector<benchmarkResult> results;	// every benchmark run on it
+};
+
+
+// Runs work the given number of times and averages the time and allocations. Setup and teardown are run around each iteration,
+// outside the timed part.
+static benchmarkResult timeWork(const string& name, double megabytes, int iterations, function<void()> setup, function<uint64_t()> work, function<void()> teardown)
+{
+	double totalSeconds = 0.0;	// the time spent in the work
+	uint64_t totalAllocations = 0;	// the allocations made by the work
+	uint64_t totalBytes = 0;	// the bytes allocated by the work
+	uint64_t operations = 0;	// what the work reports it covered
+	uint64_t peakResidentBefore = getPeakResidentBytes();	// the peak resident memory before the benchmark
+	for (int i = 0; i < iterations; i++)
+	{
+		setup();
+		uint64_t allocationsBefore = allocationCount.load();
+		uint64_t bytesBefore = allocatedBytes.load();
+		auto start = chrono::high_resolution_clock::now();
+		operations = work();
+		auto finish = chrono::high_resolution_clock::now();
+		totalAllocations += allocationCount.load() - allocationsBefore;
+		totalBytes += allocatedBytes.load() - bytesBefore;
+		totalSeconds += chrono::duration<double>(finish - start).count();
+		teardown();
+	}
+
+	benchmarkResult result;
+	result.name = name;
+	result.seconds = totalSeconds / iterations;
+	result.megabytesPerSecond = (result.seconds > 0.0) ? megabytes / result.seconds : 0.0;
+	result.operations = operations;
+	result.allocations = totalAllocations / iterations;
+	result.allocatedBytes = totalBytes / iterations;
+	result.peakResidentGrowthBytes = getPeakResidentBytes() - peakResidentBefore;
+	return result;
+}
+
+
+static benchmarkResult timeParse(const string& name, Object* (*parse)(string, parser_core::parseMode), parser_core::parseMode mode, const string& filename, double megabytes, int iterations)
+{
+	Object* obj = nullptr;	// the latest parse, which isn't freed until after its time is taken
+	return timeWork(name, megabytes, iterations,
+		[](){},
+		[&]()
+		{
+			obj = parse(filename, mode);
+			return static_cast<uint64_t>(0);
+		},
+		[&]()
+		{
+			delete obj;
+			obj = nullptr;
+		}
+	);
+}
+
+
+// Looks up every child of every object by its key, the way the converters read the trees. Returns the number of lookups.
+static uint64_t lookUpByValue(Object* obj)
+{
+	uint64_t lookups = 0;
+	for (auto child: obj->getLeaves())
+	{
+		lookups += obj->getValue(child->getKey()).size();
+		if (!child->isLeaf())
+		{
+			lookups += lookUpByValue(child);
+		}
+	}
+	return lookups;
+}
+
+
+static uint64_t lookUpByFirst(Object* obj)
+{
+	uint64_t lookups = 0;
+	for (auto child: obj->getLeaves())
+	{
+		if (obj->getFirst(child->getKey()) != nullptr)
+		{
+			lookups++;
+		}
+		if (!child->isLeaf())
+		{
+			lookups += lookUpByFirst(child);
+		}
+	}
+	return lookups;
+}
+
+
+static uint64_t lookUpByRange(Object* obj)
+{
+	uint64_t lookups = 0;
+	for (auto child: obj->getLeaves())
+	{
+		for (auto match: obj->getRange(child->getKey()))
+		{
+			if (match == child)
+			{
+				lookups++;
+			}
+		}
+		if (!child->isLeaf())
+		{
+			lookups += lookUpByRange(child);
+		}
+	}
+	return lookups;
+}
+
+
+static fileResults benchmarkFile(const string& name, const string& filename, int iterations)
+{
+	fileResults file;
+	file.name = name;
+	file.megabytes = 0.0;
+
+	ifstream source(filename, ios::in | ios::binary | ios::ate);
+	if (!source.is_open())
+	{
+		cerr << "Could not open " << filename << "\n";
+		return file;
+	}
+	file.megabytes = static_cast<double>(source.tellg()) / (1024.0 * 1024.0);
+	source.close();
+
+	file.results.push_back(timeParse("parser_8859_15::doParseFile", parser_8859_15::doParseFile, parser_core::parseMode::serial, filename, file.megabytes, iterations));
+	file.results.push_back(timeParse("parser_UTF8::doParseFile", parser_UTF8::doParseFile, parser_core::parseMode::serial, filename, file.megabytes, iterations));
+	file.results.push_back(timeParse("parser_UTF8::doParseFile parallel", parser_UTF8::doParseFile, parser_core::parseMode::parallel, filename, file.megabytes, iterations));
+	file.results.push_back(timeParse("parser_UTF8::doParseFile lazy", parser_UTF8::doParseFile, parser_core::parseMode::lazy, filename, file.megabytes, iterations));
+
+	// the first parse fills the cache, and the timed ones read from it. The cache is deleted afterwards, like the synthetic script.
+	parser_cache::enable("ParserBenchmarkCache");
+	delete parser_UTF8::doParseFile(filename, parser_core::parseMode::serial);
+	file.results.push_back(timeParse("parser_UTF8::doParseFile cached", parser_UTF8::doParseFile, parser_core::parseMode::serial, filename, file.megabytes, iterations));
+	parser_cache::disable();
+	Utils::deleteFolder("ParserBenchmarkCache");
+
+	// the lookups and serialisation all work on one tree, parsed the way the converters read game files
+	Object* obj = parser_8859_15::doParseFile(filename, parser_core::parseMode::serial);
+	if (obj == nullptr)
+	{
+		return file;
+	}
+	file.results.push_back(timeWork("Object::getValue", file.megabytes, iterations, [](){}, [&](){ return lookUpByValue(obj); }, [](){}));
+	file.results.push_back(timeWork("Object::getFirst", file.megabytes, iterations, [](){}, [&](){ return lookUpByFirst(obj); }, [](){}));
+	file.results.push_back(timeWork("Object::getRange", file.megabytes, iterations, [](){}, [&](){ return lookUpByRange(obj); }, [](){}));
+	file.results.push_back(timeWork("operator<<", file.megabytes, iterations, [](){},
+		[&]()
+		{
+			ostringstream output;
+			obj->writeTopLevel(output);
+			return static_cast<uint64_t>(output.tellp());
+		},
+		[](){}
+	));
+	delete obj;
+
+	return file;
+}
+
+
+static string jsonString(const string& text)
+{
+	ostringstream escaped;
+	escaped << '"';
+	for (unsigned char c: text)
+	{
+		if ((c == '"') || (c == '\\'))
+		{
+			escaped << '\\' << c;
+		}
+		else if (c < 0x20)
+		{
+			escaped << "\\u" << hex << setw(4) << setfill('0') << static_cast<int>(c) << dec;
+		}
+		else
+		{
+			escaped << c;
+		}
+	}
+	escaped << '"';
+	return escaped.str();
+}
+
+
+static void writeJSON(ostream& out, const vector<fileResults>& files, int iterations)
+{
+	out << "{\n";
+	out << "\t\"iterations\": " << iterations << ",\n";
+	out << "\t\"threads\": " << thread::hardware_concurrency() << ",\n";
+	out << "\t\"files\": [\n";
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		out << "\t\t{\n";
+		out << "\t\t\t\"name\": " << jsonString(files[i].name) << ",\n";
+		out << "\t\t\t\"megabytes\": " << files[i].megabytes << ",\n";
+		out << "\t\t\t\"results\": [\n";
+		for (size_t j = 0; j < files[i].results.size(); j++)
+		{
+			const benchmarkResult& result = files[i].results[j];
+			out << "\t\t\t\t{ ";
+			out << "\"name\": " << jsonString(result.name) << ", ";
+			out << "\"seconds\": " << result.seconds << ", ";
+			out << "\"megabytesPerSecond\": " << result.megabytesPerSecond << ", ";
+			out << "\"operations\": " << result.operations << ", ";
+			out << "\"allocations\": " << result.allocations << ", ";
+			out << "\"allocatedBytes\": " << result.allocatedBytes << ", ";
+			out << "\"peakResidentGrowthBytes\": " << result.peakResidentGrowthBytes;
+			out << " }" << ((j + 1 < files[i].results.size()) ? "," : "") << "\n";
+		}
+		out << "\t\t\t]\n";
+		out << "\t\t}" << ((i + 1 < files.size()) ? "," : "") << "\n";
+	}
+	out << "\t]\n";
+	out << "}\n";
+}
+
+
+int main(int argc, char* argv[])
+{
+	int iterations = 3;	// how many times each benchmark is run
+	syntheticScriptOptions options;	// the shape of the synthetic script
+	bool synthetic = false;	// whether to benchmark a synthetic script as well as the files
+	string outputFilename;	// where the JSON goes, or empty for the console
+	vector<string> filenames;	// the real files to benchmark
+	for (int i = 1; i < argc; i++)
+	{
+		string argument = argv[i];
+		bool hasValue = (i + 1 < argc);
+		if ((argument == "--iterations") && hasValue)
+		{
+			iterations = max(1, stoi(argv[++i]));
+		}
+		else if ((argument == "--depth") && hasValue)
+		{
+			options.depth = stoi(argv[++i]);
+		}
+		else if ((argument == "--breadth") && hasValue)
+		{
+			options.breadth = stoi(argv[++i]);
+		}
+		else if ((argument == "--list") && hasValue)
+		{
+			options.listSize = stoi(argv[++i]);
+		}
+		else if ((argument == "--extended") && hasValue)
+		{
+			options.extendedFraction = stod(argv[++i]);
+		}
+		else if ((argument == "--seed") && hasValue)
+		{
+			options.seed = static_cast<unsigned int>(stoul(argv[++i]));
+		}
+		else if ((argument == "--output") && hasValue)
+		{
+			outputFilename = argv[++i];
+		}
+		else if (argument == "--synthetic")
+		{
+			synthetic = true;
+		}
+		else if ((argument.size() > 1) && (argument[0] == '-'))
+		{
+			cerr << "Usage: ParserBenchmark [--iterations n] [--depth n] [--breadth n] [--list n] [--extended fraction] [--seed n] [--synthetic] [--output file] [file...]\n";
+			return -1;
+		}
+		else
+		{
+			filenames.push_back(argument);
+		}
+	}
+
+	vector<fileResults> results;	// the results for every file
+	if (synthetic || filenames.empty())
+	{
+		const string syntheticFilename = "ParserBenchmarkSynthetic.txt";	// where the synthetic script is written for the parsers to read
+		ofstream syntheticFile(syntheticFilename, ios::out | ios::binary | ios::trunc);
+		syntheticFile << generateSyntheticScript(options);
+		syntheticFile.close();
+
+		ostringstream name;
+		name << "synthetic depth=" << options.depth << " breadth=" << options.breadth << " list=" << options.listSize << " extended=" << options.extendedFraction << " seed=" << options.seed;
+		results.push_back(benchmarkFile(name.str(), syntheticFilename, iterations));
+		remove(syntheticFilename.c_str());
+	}
+	for (auto filename: filenames)
+	{
+		results.push_back(benchmarkFile(filename, filename, iterations));
+	}
+
+	if (outputFilename.empty())
+	{
+		writeJSON(cout, results, iterations);
+	}
+	else
+	{
+		ofstream output(outputFilename, ios::out | ios::trunc);
+		writeJSON(output, results, iterations);
+	}
+
+	return 0;
+}
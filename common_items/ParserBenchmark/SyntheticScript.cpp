@@ -0,0 +1,138 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#include "SyntheticScript.h"
+#include <random>
+#include <sstream>
+
+
+
+static const char* const blockKeys[] = { "history", "country", "province", "army", "navy", "trade", "diplomacy", "modifier" };
+static const char* const leafKeys[] = { "owner", "controller", "core", "culture", "religion", "base_tax", "manpower", "name", "flag", "value" };
+static const char* const tags[] = { "FRA", "ENG", "CAS", "POR", "HAB", "TUR", "MOS", "SWE" };
+static const char* const asciiNames[] = { "Paris", "London", "Toledo", "Lisboa", "Wien", "Istanbul", "Moskva", "Stockholm" };
+static const char* const extendedNames[] = { "K\xF6ln", "Z\xFCrich", "Malm\xF6", "Bras\xEDlia", "Sevilla \xBD", "\xC5land", "Gda\xF1sk", "S\xE3o Paulo" };
+
+
+class syntheticWriter
+{
+	public:
+		syntheticWriter(const syntheticScriptOptions& _options) : options(_options), random(_options.seed), text() {}
+
+		string write()
+		{
+			writeContents(0, 0);
+			return text.str();
+		}
+
+	private:
+		template<size_t size> const char* pick(const char* const (&choices)[size])
+		{
+			return choices[uniform_int_distribution<size_t>(0, size - 1)(random)];
+		}
+
+		void indent(int level)
+		{
+			for (int i = 0; i < level; i++)
+			{
+				text << '\t';
+			}
+		}
+
+		void writeLeaf(int level)
+		{
+			indent(level);
+			switch (uniform_int_distribution<int>(0, 4)(random))
+			{
+				case 0:
+					text << pick(leafKeys) << "=" << pick(tags) << "\n";
+					break;
+				case 1:
+					text << pick(leafKeys) << "=" << uniform_int_distribution<int>(0, 5000)(random) << "\n";
+					break;
+				case 2:
+					text << pick(leafKeys) << "=" << uniform_int_distribution<int>(0, 100000)(random) / 1000.0 << "\n";
+					break;
+				case 3:
+					text << uniform_int_distribution<int>(1444, 1820)(random) << "." << uniform_int_distribution<int>(1, 12)(random) << "." << uniform_int_distribution<int>(1, 28)(random) << "=yes\n";
+					break;
+				default:
+					bool extended = uniform_real_distribution<double>(0.0, 1.0)(random) < options.extendedFraction;	// whether this name has 8859-15 characters
+					text << pick(leafKeys) << "=\"" << (extended ? pick(extendedNames) : pick(asciiNames)) << "\"\n";
+					break;
+			}
+		}
+
+		void writeList(int level)
+		{
+			indent(level);
+			text << "list={ ";
+			for (int i = 0; i < options.listSize; i++)
+			{
+				text << uniform_int_distribution<int>(1, 3000)(random) << " ";
+			}
+			text << "}\n";
+		}
+
+		void writeContents(int level, int depth)
+		{
+			for (int i = 0; i < options.breadth; i++)
+			{
+				writeLeaf(level);
+			}
+			writeList(level);
+
+			if (depth >= options.depth)
+			{
+				return;
+			}
+			for (int i = 0; i < options.breadth; i++)
+			{
+				indent(level);
+				if ((depth == 0) && (i % 2 == 0))
+				{
+					text << pick(tags) << "=\n";
+				}
+				else
+				{
+					text << pick(blockKeys) << "=\n";
+				}
+				indent(level);
+				text << "{\n";
+				writeContents(level + 1, depth + 1);
+				indent(level);
+				text << "}\n";
+			}
+		}
+
+		const syntheticScriptOptions& options;	// the shape of the script
+		minstd_rand random;	// the source of the values, seeded so that every run writes the same script
+		ostringstream text;	// the script written so far
+};
+
+
+string generateSyntheticScript(const syntheticScriptOptions& options)
+{
+	syntheticWriter writer(options);
+	return writer.write();
+}
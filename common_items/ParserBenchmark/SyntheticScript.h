@@ -0,0 +1,51 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef SYNTHETIC_SCRIPT_H_
+#define SYNTHETIC_SCRIPT_H_
+
+
+
+#include <string>
+using namespace std;
+
+
+
+// The shape of a generated Paradox script. Every block below the maximum depth holds breadth child blocks, and every block holds
+// breadth leaves and one list of listSize numbers, so the size grows as breadth ^ depth.
+struct syntheticScriptOptions
+{
+	int depth = 5;	// how many levels of nested blocks there are
+	int breadth = 8;	// how many child blocks and leaves each block has
+	int listSize = 16;	// how many numbers each block's list has
+	double extendedFraction = 0.25;	// the fraction of quoted strings that contain 8859-15 characters outside ASCII
+	unsigned int seed = 1444;	// the seed for the random values, so that runs can be compared
+};
+
+
+// Writes a synthetic Paradox script in ISO 8859-15, shaped like a save: dated history entries, country tags, numbers, quoted names and lists.
+string generateSyntheticScript(const syntheticScriptOptions& options);
+
+
+
+#endif // SYNTHETIC_SCRIPT_H_
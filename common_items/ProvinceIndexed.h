@@ -0,0 +1,302 @@
+/*Copyright (c) 2017 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+
+#ifndef PROVINCE_INDEXED_H_
+#define PROVINCE_INDEXED_H_
+
+
+
+#include <iterator>
+#include <map>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+using namespace std;
+
+
+
+// Province numbers are small and dense, so tables keyed on them are kept in vectors indexed by the number rather than in std::maps. Looking
+// a province up is then an array read. Both containers below follow the parts of the std::map interface the converters use, and iterate in
+// increasing province order just as a std::map would. Province numbers must not be negative.
+
+
+// A map from province numbers to values
+template<typename T>
+class provinceIndexedMap
+{
+	public:
+		typedef pair<int, T> value_type;
+
+		template<typename entryType, typename containerType>
+		class iteratorBase
+		{
+			public:
+				typedef forward_iterator_tag iterator_category;
+				typedef pair<int, T> value_type;
+				typedef ptrdiff_t difference_type;
+				typedef entryType* pointer;
+				typedef entryType& reference;
+
+				iteratorBase(): container(nullptr), province(0) {}
+				iteratorBase(containerType* _container, size_t _province): container(_container), province(_province) { skipAbsent(); }
+				template<typename otherEntry, typename otherContainer>
+				iteratorBase(const iteratorBase<otherEntry, otherContainer>& other): container(other.container), province(other.province) {}
+
+				reference operator*() const { return container->entries[province]; }
+				pointer operator->() const { return &container->entries[province]; }
+				iteratorBase& operator++() { ++province; skipAbsent(); return *this; }
+				iteratorBase operator++(int) { iteratorBase old = *this; ++*this; return old; }
+				bool operator==(const iteratorBase& other) const { return province == other.province; }
+				bool operator!=(const iteratorBase& other) const { return province != other.province; }
+
+			private:
+				template<typename, typename> friend class iteratorBase;
+				friend class provinceIndexedMap;
+
+				void skipAbsent()
+				{
+					while ((province < container->present.size()) && !container->present[province])
+					{
+						++province;
+					}
+				}
+
+				containerType* container;	// the map being iterated over
+				size_t province;	// the current province, or the size of the map at the end
+		};
+		typedef iteratorBase<value_type, provinceIndexedMap> iterator;
+		typedef iteratorBase<const value_type, const provinceIndexedMap> const_iterator;
+
+		provinceIndexedMap(): entries(), present(), numEntries(0) {}
+
+		iterator begin() { return iterator(this, 0); }
+		iterator end() { return iterator(this, present.size()); }
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, present.size()); }
+
+		size_t size() const { return numEntries; }
+		bool empty() const { return (numEntries == 0); }
+		size_t count(int province) const { return contains(province) ? 1 : 0; }
+
+		iterator find(int province) { return contains(province) ? iterator(this, province) : end(); }
+		const_iterator find(int province) const { return contains(province) ? const_iterator(this, province) : end(); }
+
+		T& operator[](int province)
+		{
+			return insert(make_pair(province, T())).first->second;
+		}
+
+		// Like std::map::insert, leaves the value alone if the province already has one
+		pair<iterator, bool> insert(const value_type& entry)
+		{
+			if (contains(entry.first))
+			{
+				return make_pair(iterator(this, entry.first), false);
+			}
+
+			size_t province = static_cast<size_t>(entry.first);
+			if (province >= entries.size())
+			{
+				size_t oldSize = entries.size();
+				entries.resize(province + 1);
+				present.resize(province + 1, false);
+				for (size_t i = oldSize; i < entries.size(); i++)
+				{
+					entries[i].first = static_cast<int>(i);
+				}
+			}
+			entries[province].second = entry.second;
+			present[province] = true;
+			numEntries++;
+			return make_pair(iterator(this, province), true);
+		}
+
+		void erase(const_iterator position)
+		{
+			entries[position.province].second = T();
+			present[position.province] = false;
+			numEntries--;
+		}
+
+		size_t erase(int province)
+		{
+			if (!contains(province))
+			{
+				return 0;
+			}
+			erase(find(province));
+			return 1;
+		}
+
+		void clear()
+		{
+			entries.clear();
+			present.clear();
+			numEntries = 0;
+		}
+
+	private:
+		bool contains(int province) const
+		{
+			return (province >= 0) && (static_cast<size_t>(province) < present.size()) && present[province];
+		}
+
+		vector<value_type> entries;	// the value for each province number, paired with the number itself
+		vector<bool> present;	// whether each province number has a value
+		size_t numEntries;	// how many province numbers have values
+};
+
+
+// A map from province numbers to lists, such as the provinces each one maps to or borders. All the lists are packed one after another into
+// a single array, with the offset of each province's list kept alongside (compressed sparse rows). The lists are added in increasing
+// province order and can't be changed afterwards.
+template<typename T = int>
+class provinceIndexedLists
+{
+	public:
+		// One province's list
+		class list
+		{
+			public:
+				list(): first(nullptr), last(nullptr) {}
+				list(const T* _first, const T* _last): first(_first), last(_last) {}
+
+				const T* begin() const { return first; }
+				const T* end() const { return last; }
+				size_t size() const { return last - first; }
+				bool empty() const { return (first == last); }
+				const T& operator[](size_t index) const { return first[index]; }
+				const T& front() const { return *first; }
+
+			private:
+				const T* first;	// the first item in the list
+				const T* last;	// one past the last item in the list
+		};
+
+		struct value_type
+		{
+			int first;	// the province
+			list second;	// the province's list
+		};
+
+		class const_iterator
+		{
+			public:
+				typedef forward_iterator_tag iterator_category;
+				typedef provinceIndexedLists::value_type value_type;
+				typedef ptrdiff_t difference_type;
+				typedef const value_type* pointer;
+				typedef const value_type& reference;
+
+				const_iterator(): container(nullptr), entry() {}
+				const_iterator(const provinceIndexedLists* _container, size_t province): container(_container), entry()
+				{
+					entry.first = static_cast<int>(province);
+					skipAbsent();
+				}
+
+				reference operator*() const { return entry; }
+				pointer operator->() const { return &entry; }
+				const_iterator& operator++() { ++entry.first; skipAbsent(); return *this; }
+				const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+				bool operator==(const const_iterator& other) const { return entry.first == other.entry.first; }
+				bool operator!=(const const_iterator& other) const { return entry.first != other.entry.first; }
+
+			private:
+				void skipAbsent()
+				{
+					while ((static_cast<size_t>(entry.first) < container->present.size()) && !container->present[entry.first])
+					{
+						++entry.first;
+					}
+					if (static_cast<size_t>(entry.first) < container->present.size())
+					{
+						entry.second = container->get(entry.first);
+					}
+				}
+
+				const provinceIndexedLists* container;	// the lists being iterated over
+				value_type entry;	// the current province and its list
+		};
+		typedef const_iterator iterator;
+
+		provinceIndexedLists(): offsets(1, 0), present(), values(), numEntries(0) {}
+
+		explicit provinceIndexedLists(const map<int, vector<T>>& lists): offsets(1, 0), present(), values(), numEntries(0)
+		{
+			for (auto& entry: lists)
+			{
+				append(entry.first, entry.second.begin(), entry.second.end());
+			}
+		}
+
+		// Adds a province's list, which must come after every province added so far
+		template<typename inputIterator>
+		void append(int province, inputIterator first, inputIterator last)
+		{
+			size_t index = static_cast<size_t>(province);
+			if (index < present.size())
+			{
+				return;
+			}
+			offsets.resize(index + 1, static_cast<uint32_t>(values.size()));
+			present.resize(index + 1, false);
+			values.insert(values.end(), first, last);
+			offsets.push_back(static_cast<uint32_t>(values.size()));
+			present[index] = true;
+			numEntries++;
+		}
+
+		const_iterator begin() const { return const_iterator(this, 0); }
+		const_iterator end() const { return const_iterator(this, present.size()); }
+
+		size_t size() const { return numEntries; }
+		bool empty() const { return (numEntries == 0); }
+		size_t count(int province) const { return contains(province) ? 1 : 0; }
+		const_iterator find(int province) const { return contains(province) ? const_iterator(this, province) : end(); }
+
+		// The province's list, which is empty if it has none
+		list get(int province) const
+		{
+			if ((province < 0) || (static_cast<size_t>(province) >= present.size()))
+			{
+				return list();
+			}
+			return list(values.data() + offsets[province], values.data() + offsets[province + 1]);
+		}
+
+	private:
+		bool contains(int province) const
+		{
+			return (province >= 0) && (static_cast<size_t>(province) < present.size()) && present[province];
+		}
+
+		vector<uint32_t> offsets;	// where each province's list starts in values, with one more marking the end of the last
+		vector<bool> present;	// whether each province has a list, which tells an empty list apart from none at all
+		vector<T> values;	// every list, one after another
+		size_t numEntries;	// how many provinces have lists
+};
+
+
+
+#endif // PROVINCE_INDEXED_H_
@@ -221,6 +221,12 @@ bool doesFolderExist(const std::string& path)
 }
 
 
+unsigned int getProcessID()
+{
+	return GetCurrentProcessId();
+}
+
+
 std::string GetLastErrorString()
 {
 	DWORD errorCode = ::GetLastError();	// the code for the latest error
@@ -274,6 +280,71 @@ bool deleteFolder(const std::string& folder)
 }
 
 
+mappedFile::mappedFile(const std::string& path):
+	opened(false),
+	data(nullptr),
+	size(0),
+	modifiedTime(0),
+	fileHandle(INVALID_HANDLE_VALUE),
+	mappingHandle(NULL)
+{
+	fileHandle = CreateFileW(convertUTF8ToUTF16(path).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	LARGE_INTEGER fileSize;	// the size of the file
+	if (!GetFileSizeEx(fileHandle, &fileSize))
+	{
+		LOG(LogLevel::Warning) << "Could not get the size of " << path << " - " << GetLastErrorString();
+		return;
+	}
+	opened = true;
+	size = static_cast<size_t>(fileSize.QuadPart);
+
+	FILETIME lastWriteTime;	// when the file was last written
+	if (GetFileTime(fileHandle, NULL, NULL, &lastWriteTime))
+	{
+		modifiedTime = (static_cast<uint64_t>(lastWriteTime.dwHighDateTime) << 32) | lastWriteTime.dwLowDateTime;
+	}
+	if (size == 0)
+	{
+		data = "";	// an empty file can't be mapped, but is still a valid file
+		return;
+	}
+
+	mappingHandle = CreateFileMappingW(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mappingHandle != NULL)
+	{
+		data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	}
+	if (data == nullptr)
+	{
+		LOG(LogLevel::Warning) << "Could not map " << path << " - " << GetLastErrorString();
+		opened = false;
+		size = 0;
+	}
+}
+
+
+mappedFile::~mappedFile()
+{
+	if ((data != nullptr) && (size > 0))
+	{
+		UnmapViewOfFile(data);
+	}
+	if (mappingHandle != NULL)
+	{
+		CloseHandle(mappingHandle);
+	}
+	if (fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(fileHandle);
+	}
+}
+
+
 std::string convertUTF8ToASCII(std::string UTF8)
 {
 	int requiredSize = WideCharToMultiByte(20127 /*US-ASCII (7-bit)*/, 0, convertUTF8ToUTF16(UTF8).c_str(), -1, NULL, 0, "0", NULL);